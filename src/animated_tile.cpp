@@ -16,9 +16,27 @@
 
 #include "safeguards.h"
 
-/** The table/list with animated tiles. */
+/**
+ * The animated tiles that are not on the animation schedule yet; they are animated at the next tick.
+ * This is the list that is saved, so everything is taken off the schedule before saving.
+ */
 std::vector<TileIndex> _animated_tiles;
 
+/** An animated tile on the animation schedule. */
+struct ScheduledAnimatedTile {
+	TileIndex tile; ///< The animated tile.
+	TimerGameTick::TickCounter due; ///< The tick at which the tile needs animating again.
+};
+
+static constexpr uint ANIMATION_SCHEDULE_SIZE = 256; ///< Number of ticks the animation schedule spans; tiles that wait longer are looked at again every time the schedule comes round.
+
+/**
+ * The animation schedule, a timing wheel with a slot per tick. A tile is in the slot of the tick it needs
+ * animating next, so the tiles that do not have anything to do in a tick are not touched at all.
+ * Deleted tiles are not removed from their slot, they are skipped when their slot comes up.
+ */
+static std::array<std::vector<ScheduledAnimatedTile>, ANIMATION_SCHEDULE_SIZE> _animation_schedule;
+
 /**
  * Stops animation on the given tile.
  * @param tile the tile to remove
@@ -27,20 +45,9 @@ std::vector<TileIndex> _animated_tiles;
 void DeleteAnimatedTile(TileIndex tile, bool immediate)
 {
 	if (immediate) {
-		if (GetAnimatedTileState(tile) == AnimatedTileState::None) return;
-
-		/* The tile may be switched to a non-animatable tile soon, so we should remove it from the
-		 * animated tile list early. */
+		/* The tile may be switched to a non-animatable tile soon, so the state has to be cleared now. Its entries
+		 * in the animation schedule are skipped as it is not animated anymore, so they do not need to be looked for. */
 		SetAnimatedTileState(tile, AnimatedTileState::None);
-
-		/* To avoid having to move everything after this tile in the animated tile list, look for this tile
-		 * in the animated tile list and replace with last entry if not last. */
-		auto it = std::ranges::find(_animated_tiles, tile);
-		if (it == std::end(_animated_tiles)) return;
-
-		if (std::next(it) != std::end(_animated_tiles)) *it = _animated_tiles.back();
-		_animated_tiles.pop_back();
-
 		return;
 	}
 
@@ -49,7 +56,7 @@ void DeleteAnimatedTile(TileIndex tile, bool immediate)
 }
 
 /**
- * Add the given tile to the animated tile table (if it does not exist yet).
+ * Add the given tile to the animated tiles, or animate it at the next tick when it is animated already.
  * @param tile the tile to make animated
  * @param mark_dirty whether to also mark the tile dirty.
  */
@@ -57,46 +64,80 @@ void AddAnimatedTile(TileIndex tile, bool mark_dirty)
 {
 	if (mark_dirty) MarkTileDirtyByTile(tile);
 
-	const AnimatedTileState state = GetAnimatedTileState(tile);
+	/* Also an animated tile is animated at the next tick, as it might have changed in a way that makes it need
+	 * animating sooner than it was scheduled for. Tiles that are on the schedule twice are animated once per tick. */
+	_animated_tiles.push_back(tile);
+	SetAnimatedTileState(tile, AnimatedTileState::Animated);
+}
 
-	/* Tile is already animated so nothing needs to happen. */
-	if (state == AnimatedTileState::Animated) return;
+/**
+ * Animate the given tile at the next tick, if it is animated. This is needed when the
+ * tile changed in a way that makes it need animating sooner than it was scheduled for.
+ * @param tile the tile that changed
+ */
+void RescheduleAnimatedTile(TileIndex tile)
+{
+	if (GetAnimatedTileState(tile) == AnimatedTileState::Animated) _animated_tiles.push_back(tile);
+}
 
-	/* Tile has no previous animation state, so add to the tile list. If the state is anything
-	 * other than None (e.g. Deleted) then the tile will still be in the list and does not need to be added again. */
-	if (state == AnimatedTileState::None) _animated_tiles.push_back(tile);
+/**
+ * Take all tiles off the animation schedule, so they are animated at the next tick.
+ * This is done before saving, so the saved list is complete, and when the animation speeds might have changed.
+ */
+void UnscheduleAnimatedTiles()
+{
+	for (std::vector<ScheduledAnimatedTile> &slot : _animation_schedule) {
+		for (const ScheduledAnimatedTile &scheduled : slot) _animated_tiles.push_back(scheduled.tile);
+		slot.clear();
+	}
 
-	SetAnimatedTileState(tile, AnimatedTileState::Animated);
+	std::erase_if(_animated_tiles, [](TileIndex tile) { return !MayAnimateTile(tile) || GetAnimatedTileState(tile) == AnimatedTileState::None; });
+	std::ranges::sort(_animated_tiles);
+	auto [first, last] = std::ranges::unique(_animated_tiles);
+	_animated_tiles.erase(first, last);
 }
 
 /**
- * Animate all tiles in the animated tile list, i.e.\ call AnimateTile on them.
+ * Animate all tiles that need animating this tick, i.e.\ call AnimateTile on them.
  */
 void AnimateAnimatedTiles()
 {
 	PerformanceAccumulator landscape_framerate(PerformanceElement::GameLoopLandscape);
 
-	for (auto it = std::begin(_animated_tiles); it != std::end(_animated_tiles); /* nothing */) {
-		TileIndex &tile = *it;
-
-		if (GetAnimatedTileState(tile) != AnimatedTileState::Animated) {
-			/* Tile should not be animated any more, mark it as not animated and erase it from the list. */
-			SetAnimatedTileState(tile, AnimatedTileState::None);
-
-			/* Removing the last entry, no need to swap and continue. */
-			if (std::next(it) == std::end(_animated_tiles)) {
-				_animated_tiles.pop_back();
-				break;
+	const TimerGameTick::TickCounter now = TimerGameTick::counter;
+	std::vector<ScheduledAnimatedTile> &slot = _animation_schedule[now % ANIMATION_SCHEDULE_SIZE];
+
+	/* The newly animated tiles and the tiles in this slot that are due now. Tiles that are
+	 * animated while animating go to _animated_tiles again, so they are done next tick. */
+	std::vector<TileIndex> due;
+	due.swap(_animated_tiles);
+	auto due_now = std::ranges::partition(slot, [now](const ScheduledAnimatedTile &scheduled) { return scheduled.due > now; });
+	for (const ScheduledAnimatedTile &scheduled : due_now) due.push_back(scheduled.tile);
+	slot.erase(due_now.begin(), due_now.end());
+
+	/* Animate the tiles in tile order, so the order does not depend on how the tiles got on the schedule. That
+	 * way a game that was just loaded animates them in the same order as the game it was saved from. */
+	std::ranges::sort(due);
+	auto [first, last] = std::ranges::unique(due);
+	due.erase(first, last);
+
+	for (TileIndex tile : due) {
+		/* The tile was changed into something that cannot be animated after its animation was stopped. */
+		if (!MayAnimateTile(tile)) continue;
+
+		if (GetAnimatedTileState(tile) == AnimatedTileState::Animated) {
+			uint wait = AnimateTile(tile);
+			if (!MayAnimateTile(tile)) continue;
+
+			if (GetAnimatedTileState(tile) == AnimatedTileState::Animated) {
+				TimerGameTick::TickCounter next = now + wait;
+				_animation_schedule[next % ANIMATION_SCHEDULE_SIZE].push_back({tile, next});
+				continue;
 			}
-
-			/* Replace the current list entry with the back of the list to avoid moving elements. */
-			*it = _animated_tiles.back();
-			_animated_tiles.pop_back();
-			continue;
 		}
 
-		AnimateTile(tile);
-		++it;
+		/* Tile should not be animated any more, mark it as not animated. */
+		SetAnimatedTileState(tile, AnimatedTileState::None);
 	}
 }
 
@@ -106,4 +147,5 @@ void AnimateAnimatedTiles()
 void InitializeAnimatedTiles()
 {
 	_animated_tiles.clear();
+	for (std::vector<ScheduledAnimatedTile> &slot : _animation_schedule) slot.clear();
 }
@@ -11,10 +11,23 @@
 #define ANIMATED_TILE_FUNC_H
 
 #include "tile_type.h"
+#include "timer/timer_game_tick.h"
 
 void AddAnimatedTile(TileIndex tile, bool mark_dirty = true);
 void DeleteAnimatedTile(TileIndex tile, bool immediate = false);
+void RescheduleAnimatedTile(TileIndex tile);
+void UnscheduleAnimatedTiles();
 void AnimateAnimatedTiles();
 void InitializeAnimatedTiles();
 
+/**
+ * Get the number of ticks until an animation that only runs when the tick counter is a multiple of \a period runs again.
+ * @param period The number of ticks between the animation steps, a power of two.
+ * @return The number of ticks to wait, between 1 and \a period.
+ */
+inline uint GetAnimationWait(uint period)
+{
+	return period - static_cast<uint>(TimerGameTick::counter % period);
+}
+
 #endif /* ANIMATED_TILE_FUNC_H */
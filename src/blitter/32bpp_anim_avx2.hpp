@@ -0,0 +1,60 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file 32bpp_anim_avx2.hpp AVX2 32 bpp blitter with animation support. */
+
+#ifndef BLITTER_32BPP_AVX2_ANIM_HPP
+#define BLITTER_32BPP_AVX2_ANIM_HPP
+
+#ifdef WITH_SSE
+
+#ifndef SSE_VERSION
+#define SSE_VERSION 5
+#endif
+
+#ifndef SSE_TARGET
+#define SSE_TARGET "avx2"
+#endif
+
+#ifndef FULL_ANIMATION
+#define FULL_ANIMATION 1
+#endif
+
+#include "32bpp_anim.hpp"
+#include "32bpp_anim_sse2.hpp"
+#include "32bpp_avx2.hpp"
+
+#undef MARGIN_NORMAL_THRESHOLD
+#define MARGIN_NORMAL_THRESHOLD 4
+
+/** The AVX2 32 bpp blitter with palette animation. */
+class Blitter_32bppAVX2_Anim final : public Blitter_32bppSSE2_Anim, public Blitter_32bppAVX2 {
+public:
+	template <BlitterMode mode, Blitter_32bppSSE_Base::ReadMode read_mode, Blitter_32bppSSE_Base::BlockType bt_last, bool translucent, bool animated>
+	void Draw(const Blitter::BlitterParams *bp, ZoomLevel zoom);
+	template <BlitterMode mode, Blitter_32bppSSE_Base::ReadMode read_mode, Blitter_32bppSSE_Base::BlockType bt_last, bool translucent>
+	void Draw(const Blitter::BlitterParams *bp, ZoomLevel zoom, bool animated);
+	void Draw(Blitter::BlitterParams *bp, BlitterMode mode, ZoomLevel zoom) override;
+	void PaletteAnimate(const Palette &palette) override;
+
+	Sprite *Encode(SpriteType sprite_type, const SpriteLoader::SpriteCollection &sprite, SpriteAllocator &allocator) override
+	{
+		return Blitter_32bppSSE_Base::Encode(sprite_type, sprite, allocator);
+	}
+	std::string_view GetName() override { return "32bpp-avx2-anim"; }
+	using Blitter_32bppSSE2_Anim::LookupColourInPalette;
+};
+
+/** Factory for the AVX2 32 bpp blitter (with palette animation). */
+class FBlitter_32bppAVX2_Anim : public BlitterFactory {
+public:
+	FBlitter_32bppAVX2_Anim() : BlitterFactory("32bpp-avx2-anim", "32bpp AVX2 Blitter (palette animation)", HasCPUIDFlag(7, 1, 5) && HasOSAVXSupport()) {}
+	std::unique_ptr<Blitter> CreateInstance() override { return std::unique_ptr<Blitter>(static_cast<Blitter_32bppSSE2_Anim *>(new Blitter_32bppAVX2_Anim())); }
+};
+
+#endif /* WITH_SSE */
+#endif /* BLITTER_32BPP_AVX2_ANIM_HPP */
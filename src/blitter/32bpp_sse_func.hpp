@@ -119,6 +119,56 @@ INTERNAL_LINKAGE inline __m128i DarkenTwoPixels(__m128i src, __m128i dst, const
 	return _mm_packus_epi16(dstAB, dstAB);
 }
 
+#if (SSE_VERSION >= 5)
+/**
+ * Alpha blend 8 pixels; the same as #AlphaBlendTwoPixels for each half of the registers.
+ * The masks are the 128 bits masks, broadcast to both lanes.
+ */
+GNU_TARGET(SSE_TARGET)
+INTERNAL_LINKAGE inline __m256i AlphaBlendEightPixels(__m256i src, __m256i dst, const __m256i &distribution_mask, const __m256i &clear_hi_mask, const __m256i &alpha_mask)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	__m256i result[2];
+	for (int i = 0; i < 2; i++) {
+		__m256i srcAB = i == 0 ? _mm256_unpacklo_epi8(src, zero) : _mm256_unpackhi_epi8(src, zero);
+		__m256i dstAB = i == 0 ? _mm256_unpacklo_epi8(dst, zero) : _mm256_unpackhi_epi8(dst, zero);
+
+		__m256i alphaMaskAB = _mm256_cmpgt_epi16(srcAB, zero);
+		__m256i alphaAB = _mm256_sub_epi16(srcAB, alphaMaskAB);
+		alphaAB = _mm256_shuffle_epi8(alphaAB, distribution_mask);
+
+		srcAB = _mm256_sub_epi16(srcAB, dstAB);
+		srcAB = _mm256_mullo_epi16(srcAB, alphaAB);
+		srcAB = _mm256_srli_epi16(srcAB, 8);
+		srcAB = _mm256_add_epi16(srcAB, dstAB);
+
+		alphaMaskAB = _mm256_and_si256(alphaMaskAB, alpha_mask);
+		srcAB = _mm256_or_si256(srcAB, alphaMaskAB);
+		result[i] = _mm256_and_si256(srcAB, clear_hi_mask); // Keep the low bytes, so packing does not saturate.
+	}
+	/* Unpacking and packing both work per lane, so the pixels end up in their original order. */
+	return _mm256_packus_epi16(result[0], result[1]);
+}
+
+/** Darken 8 pixels; the same as #DarkenTwoPixels for each half of the registers. */
+GNU_TARGET(SSE_TARGET)
+INTERNAL_LINKAGE inline __m256i DarkenEightPixels(__m256i src, __m256i dst, const __m256i &distribution_mask, const __m256i &tr_nom_base)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	__m256i result[2];
+	for (int i = 0; i < 2; i++) {
+		__m256i srcAB = i == 0 ? _mm256_unpacklo_epi8(src, zero) : _mm256_unpackhi_epi8(src, zero);
+		__m256i dstAB = i == 0 ? _mm256_unpacklo_epi8(dst, zero) : _mm256_unpackhi_epi8(dst, zero);
+		__m256i alphaAB = _mm256_shuffle_epi8(srcAB, distribution_mask);
+		alphaAB = _mm256_srli_epi16(alphaAB, 2);
+		__m256i nom = _mm256_sub_epi16(tr_nom_base, alphaAB);
+		dstAB = _mm256_mullo_epi16(dstAB, nom);
+		result[i] = _mm256_srli_epi16(dstAB, 8);
+	}
+	return _mm256_packus_epi16(result[0], result[1]);
+}
+#endif /* SSE_VERSION >= 5 */
+
 GNU_TARGET(SSE_TARGET)
 INTERNAL_LINKAGE Colour ReallyAdjustBrightness(Colour colour, uint8_t brightness)
 {
@@ -219,6 +269,8 @@ inline void Blitter_32bppSSE2::Draw(const Blitter::BlitterParams *bp, ZoomLevel
 inline void Blitter_32bppSSSE3::Draw(const Blitter::BlitterParams *bp, ZoomLevel zoom)
 #elif (SSE_VERSION == 4)
 inline void Blitter_32bppSSE4::Draw(const Blitter::BlitterParams *bp, ZoomLevel zoom)
+#elif (SSE_VERSION == 5)
+inline void Blitter_32bppAVX2::Draw(const Blitter::BlitterParams *bp, ZoomLevel zoom)
 #endif
 {
 	const uint8_t * const remap = bp->remap;
@@ -255,6 +307,12 @@ inline void Blitter_32bppSSE4::Draw(const Blitter::BlitterParams *bp, ZoomLevel
 	#define DARKEN_PARAM_2      tr_nom_base
 #endif
 	const __m128i tr_nom_base = TRANSPARENT_NOM_BASE;
+#if (SSE_VERSION >= 5)
+	const __m256i alpha_and_8   = _mm256_broadcastsi128_si256(ALPHA_AND_MASK);
+	const __m256i a_cm_8        = _mm256_broadcastsi128_si256(ALPHA_CONTROL_MASK);
+	const __m256i clear_hi_8    = _mm256_broadcastsi128_si256(CLEAR_HIGH_BYTE_MASK);
+	const __m256i tr_nom_base_8 = _mm256_broadcastsi128_si256(TRANSPARENT_NOM_BASE);
+#endif
 
 	for (int y = bp->height; y != 0; y--) {
 		Colour *dst = dst_line;
@@ -285,7 +343,19 @@ inline void Blitter_32bppSSE4::Draw(const Blitter::BlitterParams *bp, ZoomLevel
 					break;
 				}
 
+#if (SSE_VERSION >= 5)
+				for (uint x = (uint) effective_width / 8; x > 0; x--) {
+					__m256i srcABCD = _mm256_loadu_si256((const __m256i *) src);
+					__m256i dstABCD = _mm256_loadu_si256((__m256i *) dst);
+					_mm256_storeu_si256((__m256i *) dst, AlphaBlendEightPixels(srcABCD, dstABCD, a_cm_8, clear_hi_8, alpha_and_8));
+					src += 8;
+					dst += 8;
+				}
+
+				for (uint x = ((uint) effective_width % 8) / 2; x > 0; x--) {
+#else
 				for (uint x = (uint) effective_width / 2; x > 0; x--) {
+#endif
 					__m128i srcABCD = _mm_loadl_epi64((const __m128i*) src);
 					__m128i dstABCD = _mm_loadl_epi64((__m128i*) dst);
 					_mm_storel_epi64((__m128i*) dst, AlphaBlendTwoPixels(srcABCD, dstABCD, ALPHA_BLEND_PARAM_1, ALPHA_BLEND_PARAM_2, ALPHA_BLEND_PARAM_3));
@@ -384,7 +454,19 @@ bmcr_alpha_blend_single:
 
 			case BlitterMode::Transparent:
 				/* Make the current colour a bit more black, so it looks like this image is transparent. */
+#if (SSE_VERSION >= 5)
+				for (uint x = (uint) bp->width / 8; x > 0; x--) {
+					__m256i srcABCD = _mm256_loadu_si256((const __m256i *) src);
+					__m256i dstABCD = _mm256_loadu_si256((__m256i *) dst);
+					_mm256_storeu_si256((__m256i *) dst, DarkenEightPixels(srcABCD, dstABCD, a_cm_8, tr_nom_base_8));
+					src += 8;
+					dst += 8;
+				}
+
+				for (uint x = ((uint) bp->width % 8) / 2; x > 0; x--) {
+#else
 				for (uint x = (uint) bp->width / 2; x > 0; x--) {
+#endif
 					__m128i srcABCD = _mm_loadl_epi64((const __m128i*) src);
 					__m128i dstABCD = _mm_loadl_epi64((__m128i*) dst);
 					_mm_storel_epi64((__m128i *) dst, DarkenTwoPixels(srcABCD, dstABCD, DARKEN_PARAM_1, DARKEN_PARAM_2));
@@ -460,6 +542,8 @@ void Blitter_32bppSSE2::Draw(Blitter::BlitterParams *bp, BlitterMode mode, ZoomL
 void Blitter_32bppSSSE3::Draw(Blitter::BlitterParams *bp, BlitterMode mode, ZoomLevel zoom)
 #elif (SSE_VERSION == 4)
 void Blitter_32bppSSE4::Draw(Blitter::BlitterParams *bp, BlitterMode mode, ZoomLevel zoom)
+#elif (SSE_VERSION == 5)
+void Blitter_32bppAVX2::Draw(Blitter::BlitterParams *bp, BlitterMode mode, ZoomLevel zoom)
 #endif
 {
 	switch (mode) {
@@ -12,6 +12,7 @@
 #include "company_base.h"
 #include "debug.h"
 #include "industry.h"
+#include "road_map.h"
 #include "roadstop_base.h"
 #include "roadveh.h"
 #include "ship.h"
@@ -21,6 +22,7 @@
 #include "town.h"
 #include "train.h"
 #include "vehicle_base.h"
+#include "vehicle_func.h"
 
 #include "safeguards.h"
 
@@ -224,6 +226,15 @@ void CheckCaches()
 		i++;
 	}
 
+	/* Check the level crossing occupancy. */
+	for (const TileIndex tile : Map::Iterate()) {
+		if (!IsLevelCrossingTile(tile)) continue;
+		bool occupied = HasVehicleOnTile(tile, [](const Vehicle *v) { return v->type == VehicleType::Train; });
+		if (occupied != TrainOnCrossing(tile)) {
+			Debug(desync, 2, "warning: level crossing occupancy mismatch: tile {}", tile);
+		}
+	}
+
 	/* Check the last vehicle cache. */
 	for (Vehicle *v : Vehicle::Iterate()) {
 		if (v != v->First() || v->vehstatus.Test(VehState::Crashed) || !v->IsPrimaryVehicle()) continue;
@@ -38,6 +38,7 @@
 #include "ai/ai_config.hpp"
 #include "newgrf.h"
 #include "newgrf_profiling.h"
+#include "newgrf_storage.h"
 #include "console_func.h"
 #include "engine_base.h"
 #include "road.h"
@@ -1770,11 +1771,12 @@ static bool ConAlias(std::span<std::string_view> argv)
 static bool ConScreenShot(std::span<std::string_view> argv)
 {
 	if (argv.empty()) {
-		IConsolePrint(CC_HELP, "Create a screenshot of the game. Usage: 'screenshot [viewport | normal | big | giant | heightmap | minimap] [no_con] [size <width> <height>] [<filename>]'.");
+		IConsolePrint(CC_HELP, "Create a screenshot of the game. Usage: 'screenshot [viewport | normal | big | giant | tiles | heightmap | minimap] [no_con] [size <width> <height>] [<filename>]'.");
 		IConsolePrint(CC_HELP, "  'viewport' (default) makes a screenshot of the current viewport (including menus, windows).");
 		IConsolePrint(CC_HELP, "  'normal' makes a screenshot of the visible area.");
 		IConsolePrint(CC_HELP, "  'big' makes a zoomed-in screenshot of the visible area.");
 		IConsolePrint(CC_HELP, "  'giant' makes a screenshot of the whole map.");
+		IConsolePrint(CC_HELP, "  'tiles' makes a directory with square tiles of the whole map for each zoom level, for a web map viewer.");
 		IConsolePrint(CC_HELP, "  'heightmap' makes a heightmap screenshot of the map that can be loaded in as heightmap.");
 		IConsolePrint(CC_HELP, "  'minimap' makes a top-viewed minimap screenshot of the whole world which represents one tile by one pixel.");
 		IConsolePrint(CC_HELP, "  'no_con' hides the console to create the screenshot (only useful in combination with 'viewport').");
@@ -1804,6 +1806,9 @@ static bool ConScreenShot(std::span<std::string_view> argv)
 		} else if (argv[arg_index] == "giant") {
 			type = SC_WORLD;
 			arg_index += 1;
+		} else if (argv[arg_index] == "tiles") {
+			type = SC_WORLD_TILES;
+			arg_index += 1;
 		} else if (argv[arg_index] == "heightmap") {
 			type = SC_HEIGHTMAP;
 			arg_index += 1;
@@ -2643,6 +2648,10 @@ static bool ConNewGRFProfile(std::span<std::string_view> argv)
 		IConsolePrint(CC_HELP, "  End profiling and write the collected data to CSV files.");
 		IConsolePrint(CC_HELP, "Usage: 'newgrf_profile abort':");
 		IConsolePrint(CC_HELP, "  End profiling and discard all collected data.");
+		IConsolePrint(CC_HELP, "Usage: 'newgrf_profile mode trace|aggregate [<sample-interval>]':");
+		IConsolePrint(CC_HELP, "  Set how the next started profiles collect data. 'trace' records every call; 'aggregate' counts calls per sprite group, callback and feature, timing one in <sample-interval> calls.");
+		IConsolePrint(CC_HELP, "Usage: 'newgrf_profile top [<count>]':");
+		IConsolePrint(CC_HELP, "  Show the sprite groups that took the most time in the running aggregate profiles.");
 		return true;
 	}
 
@@ -2748,6 +2757,64 @@ static bool ConNewGRFProfile(std::span<std::string_view> argv)
 		return true;
 	}
 
+	/* "mode" sub-command */
+	if (StrStartsWithIgnoreCase(argv[1], "mod") && argv.size() >= 3) {
+		if (StrStartsWithIgnoreCase(argv[2], "tra")) {
+			NewGRFProfiler::start_mode = NewGRFProfiler::Mode::Trace;
+		} else if (StrStartsWithIgnoreCase(argv[2], "agg")) {
+			NewGRFProfiler::start_mode = NewGRFProfiler::Mode::Aggregate;
+		} else {
+			IConsolePrint(CC_ERROR, "Unknown profiling mode '{}'.", argv[2]);
+			return true;
+		}
+
+		if (argv.size() >= 4) {
+			auto interval = ParseInteger<uint>(argv[3]);
+			if (!interval.has_value() || *interval < 1) {
+				IConsolePrint(CC_ERROR, "No valid sample interval was given.");
+				return true;
+			}
+			NewGRFProfiler::start_sample_interval = *interval;
+		}
+		IConsolePrint(CC_DEBUG, "Profiles started from now on use {} mode{}.",
+				NewGRFProfiler::start_mode == NewGRFProfiler::Mode::Aggregate ? "aggregate" : "trace",
+				NewGRFProfiler::start_mode == NewGRFProfiler::Mode::Aggregate ? fmt::format(", timing one in {} calls", NewGRFProfiler::start_sample_interval) : "");
+		return true;
+	}
+
+	/* "top" sub-command */
+	if (StrStartsWithIgnoreCase(argv[1], "top")) {
+		size_t count = 10;
+		if (argv.size() >= 3) {
+			auto value = ParseInteger<size_t>(argv[2]);
+			if (!value.has_value()) {
+				IConsolePrint(CC_ERROR, "No valid count was given.");
+				return true;
+			}
+			count = *value;
+		}
+
+		bool any = false;
+		for (const NewGRFProfiler &pr : _newgrf_profilers) {
+			if (!pr.active || pr.mode != NewGRFProfiler::Mode::Aggregate) continue;
+			any = true;
+
+			uint64_t ticks = std::max<uint64_t>(1, TimerGameTick::counter - pr.start_tick);
+			uint64_t total = pr.GetEstimatedNanoseconds();
+			IConsolePrint(CC_INFO, "[{}] {}: {} us over {} ticks, {:.1f} us per tick", FormatArrayAsHex(pr.grffile->grfid), pr.grffile->filename, total / 1000, ticks, total / 1000.0 / ticks);
+
+			int rank = 1;
+			for (const NewGRFProfiler::Aggregate *a : pr.GetTopAggregates(count)) {
+				IConsolePrint(CC_DEFAULT, "  {:>3}. sprite {}, feature 0x{:02X}, callback 0x{:X}: {} calls, {} us, {:.2f} us per call, max {} us",
+						rank++, a->root_sprite, a->feat, (uint)a->cb, a->calls, a->GetEstimatedNanoseconds() / 1000,
+						a->GetEstimatedNanoseconds() / 1000.0 / a->calls, a->max_nanoseconds / 1000);
+			}
+			if (pr.overflow_calls > 0) IConsolePrint(CC_WARNING, "  {} calls did not fit in the aggregate table.", pr.overflow_calls);
+		}
+		if (!any) IConsolePrint(CC_ERROR, "No aggregate profiles are running.");
+		return true;
+	}
+
 	return false;
 }
 
@@ -2929,13 +2996,24 @@ static void ConDumpCargoTypes()
 	}
 }
 
+/** Show the statistics of the writes to NewGRF persistent storage. */
+static void ConDumpPersistentStorage()
+{
+	auto print = [](std::string_view name, const PersistentStorageStats &stats) {
+		IConsolePrint(CC_DEFAULT, "  {}: {} writes, {} temporary writes, {} reverted writes in {} arrays",
+				name, stats.writes, stats.temporary_writes, stats.reverted_writes, stats.reverted_arrays);
+	};
+	print("Last tick", BasePersistentStorageArray::GetLastTickStats());
+	print("Total", BasePersistentStorageArray::GetTotalStats());
+}
+
 /** Dump information about some NewGRF types. @copydoc IConsoleCmdProc */
 static bool ConDumpInfo(std::span<std::string_view> argv)
 {
 	if (argv.size() != 2) {
 		IConsolePrint(CC_HELP, "Dump debugging information.");
-		IConsolePrint(CC_HELP, "Usage: 'dump_info roadtypes|railtypes|cargotypes'.");
-		IConsolePrint(CC_HELP, "  Show information about road/tram types, rail types or cargo types.");
+		IConsolePrint(CC_HELP, "Usage: 'dump_info roadtypes|railtypes|cargotypes|storage'.");
+		IConsolePrint(CC_HELP, "  Show information about road/tram types, rail types, cargo types or writes to NewGRF persistent storage.");
 		return true;
 	}
 
@@ -2954,6 +3032,11 @@ static bool ConDumpInfo(std::span<std::string_view> argv)
 		return true;
 	}
 
+	if (StrEqualsIgnoreCase(argv[1], "storage")) {
+		ConDumpPersistentStorage();
+		return true;
+	}
+
 	return false;
 }
 
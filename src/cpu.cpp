@@ -10,6 +10,10 @@
 #include "stdafx.h"
 #include "core/bitmath_func.hpp"
 
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#	include <immintrin.h>
+#endif
+
 #include "safeguards.h"
 
 /** Container for CPUID information. */
@@ -27,6 +31,7 @@ using CPUIDArray = std::array<int, 4>;
  *
  * Other platforms/architectures don't have CPUID, so zero the info and then
  * most (if not all) of the features are set as if they do not exist.
+ * Sub-leaf 0 is requested, as the extended features of type 7 depend on it.
  * @param type The information this instruction should retrieve.
  * @return The retrieved info. All zeros on architectures without CPUID.
  */
@@ -34,7 +39,7 @@ static CPUIDArray CPUID([[maybe_unused]] int type)
 {
 	CPUIDArray info{};
 #if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
-	__cpuid(info.data(), type);
+	__cpuidex(info.data(), type, 0);
 #elif defined(__i386) && defined(__PIC__)
 	/* The easy variant would be just cpuid, however... ebx is being used by the GOT (Global Offset Table)
 	 * in case of PIC;
@@ -50,13 +55,13 @@ static CPUIDArray CPUID([[maybe_unused]] int type)
 			/* It is safe to write "=r" for (info[1]) as in case that PIC is enabled for i386,
 			 * the compiler will not choose EBX as target register (but something else).
 			 */
-			: "a" (type)
+			: "a" (type), "c" (0)
 	);
 #elif defined(__x86_64__) || defined(__i386)
 	__asm__ __volatile__ (
 			"cpuid           \n\t"
 			: "=a" (info[0]), "=b" (info[1]), "=c" (info[2]), "=d" (info[3])
-			: "a" (type)
+			: "a" (type), "c" (0)
 	);
 #elif defined(__e2k__) /* MCST Elbrus 2000*/
 	if (type == 0) {
@@ -86,3 +91,20 @@ bool HasCPUIDFlag(uint type, uint index, uint bit)
 	cpu_info = CPUID(type);
 	return HasBit(cpu_info[index], bit);
 }
+
+bool HasOSAVXSupport()
+{
+	/* The OS must have enabled XSAVE (OSXSAVE) and the CPU must know AVX, before XGETBV can be asked. */
+	if (!HasCPUIDFlag(1, 2, 27) || !HasCPUIDFlag(1, 2, 28)) return false;
+
+	/* Both the SSE (bit 1) and AVX (bit 2) register state must be saved by the OS. */
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+	return (_xgetbv(0) & 0x6) == 0x6;
+#elif defined(__x86_64__) || defined(__i386)
+	uint32_t eax, edx;
+	__asm__ __volatile__ ("xgetbv" : "=a" (eax), "=d" (edx) : "c" (0));
+	return (eax & 0x6) == 0x6;
+#else
+	return false;
+#endif
+}
@@ -19,4 +19,10 @@
  */
 bool HasCPUIDFlag(uint type, uint index, uint bit);
 
+/**
+ * Check whether the operating system saves the AVX registers, which is needed to use AVX and AVX2 instructions.
+ * @return True iff the CPU supports AVX and the operating system has enabled it.
+ */
+bool HasOSAVXSupport();
+
 #endif /* CPU_H */
@@ -9,6 +9,8 @@
 
 #include "stdafx.h"
 #include "depot_base.h"
+#include "depot_func.h"
+#include "depot_kdtree.h"
 #include "order_backup.h"
 #include "order_func.h"
 #include "window_func.h"
@@ -22,6 +24,38 @@
 DepotPool _depot_pool("Depot");
 INSTANTIATE_POOL_METHODS(Depot)
 
+DepotKdtree _depot_kdtree{};
+
+/** Rebuild the k-d tree of depots from the depot pool. */
+void RebuildDepotKdtree()
+{
+	std::vector<DepotID> depots;
+	for (const Depot *depot : Depot::Iterate()) {
+		depots.push_back(depot->index);
+	}
+	_depot_kdtree.Build(depots.begin(), depots.end());
+}
+
+/**
+ * Check whether a company has a depot of some type close to a tile.
+ * This is a cheap test before running a pathfinder to find the nearest depot:
+ * when it fails, there is no depot that can be reached within \a distance tiles.
+ * @param tile The tile to search around.
+ * @param distance The maximum Manhattan distance to the depot.
+ * @param type The tile type of the depot.
+ * @param owner The owner of the depot.
+ * @return True iff there is such a depot.
+ */
+bool IsCompanyDepotNearby(TileIndex tile, uint distance, TileType type, Owner owner)
+{
+	bool found = false;
+	ForAllDepotsRadius(tile, distance, [&](const Depot *depot) {
+		if (found || !IsTileType(depot->xy, type) || !IsTileOwner(depot->xy, owner)) return;
+		found = DistanceManhattan(tile, depot->xy) <= distance;
+	});
+	return found;
+}
+
 /**
  * Remove any references to this depot.
  */
@@ -29,6 +63,8 @@ Depot::~Depot()
 {
 	if (CleaningPool()) return;
 
+	_depot_kdtree.Remove(this->index);
+
 	if (!IsDepotTile(this->xy) || GetDepotIndex(this->xy) != this->index) {
 		/* It can happen there is no depot here anymore (TTO/TTD savegames) */
 		return;
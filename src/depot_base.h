@@ -45,4 +45,6 @@ struct Depot : DepotPool::PoolItem<&_depot_pool> {
 	}
 };
 
+void RebuildDepotKdtree();
+
 #endif /* DEPOT_BASE_H */
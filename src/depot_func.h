@@ -12,12 +12,16 @@
 
 #include "vehicle_type.h"
 #include "slope_func.h"
+#include "tile_type.h"
+#include "company_type.h"
 
 void ShowDepotWindow(TileIndex tile, VehicleType type);
 void InitDepotWindowBlockSizes();
 
 void DeleteDepotHighlightOfVehicle(const Vehicle *v);
 
+bool IsCompanyDepotNearby(TileIndex tile, uint distance, TileType type, Owner owner);
+
 /**
  * Find out if the slope of the tile is suitable to build a depot of given direction
  * @param direction The direction in which the depot's exit points
@@ -0,0 +1,47 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file depot_kdtree.h Declarations for accessing the k-d tree of depots. */
+
+#ifndef DEPOT_KDTREE_H
+#define DEPOT_KDTREE_H
+
+#include "core/kdtree.hpp"
+#include "depot_base.h"
+#include "map_func.h"
+
+struct Kdtree_DepotXYFunc {
+	inline uint16_t operator()(DepotID depot, int dim)
+	{
+		return (dim == 0) ? TileX(Depot::Get(depot)->xy) : TileY(Depot::Get(depot)->xy);
+	}
+};
+
+using DepotKdtree = Kdtree<DepotID, Kdtree_DepotXYFunc, uint16_t, int>;
+extern DepotKdtree _depot_kdtree;
+
+/**
+ * Call a function on all depots within a radius of a center tile.
+ * @param center  Central tile to search around.
+ * @param radius  Distance in both X and Y to search within.
+ * @param func    The function to call, must take a single parameter which is Depot*.
+ */
+template <typename Func>
+void ForAllDepotsRadius(TileIndex center, uint radius, Func func)
+{
+	uint16_t x1, y1, x2, y2;
+	x1 = (uint16_t)std::max<int>(0, TileX(center) - radius);
+	x2 = (uint16_t)std::min<int>(TileX(center) + radius + 1, Map::SizeX());
+	y1 = (uint16_t)std::max<int>(0, TileY(center) - radius);
+	y2 = (uint16_t)std::min<int>(TileY(center) + radius + 1, Map::SizeY());
+
+	_depot_kdtree.FindContained(x1, y1, x2, y2, [&](DepotID id) {
+		func(Depot::Get(id));
+	});
+}
+
+#endif /* DEPOT_KDTREE_H */
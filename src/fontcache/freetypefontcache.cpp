@@ -183,11 +183,8 @@ const Sprite *FreeTypeFontCache::InternalGetGlyph(GlyphID key, bool aa)
 		}
 	}
 
-	UniquePtrSpriteAllocator allocator;
-	BlitterFactory::GetCurrentBlitter()->Encode(SpriteType::Font, spritecollection, allocator);
-
 	GlyphEntry new_glyph;
-	new_glyph.data = std::move(allocator.data);
+	new_glyph.sprite = BlitterFactory::GetCurrentBlitter()->Encode(SpriteType::Font, spritecollection, this->glyph_atlas);
 	new_glyph.width = slot->advance.x >> 6;
 
 	return this->SetGlyphPtr(key, std::move(new_glyph)).GetSprite();
@@ -11,6 +11,7 @@
 #include "../debug.h"
 #include "../fontcache.h"
 #include "../core/bitmath_func.hpp"
+#include "../core/math_func.hpp"
 #include "../gfx_layout.h"
 #include "truetypefontcache.h"
 
@@ -39,13 +40,48 @@ TrueTypeFontCache::~TrueTypeFontCache()
  */
 void TrueTypeFontCache::ClearFontCache()
 {
+	this->glyph_index.clear();
 	this->glyph_to_sprite_map.clear();
+	this->glyph_atlas.Clear();
 	Layouter::ResetFontCache(this->fs);
 }
 
+/**
+ * Free all sprites in the atlas at once.
+ */
+void TrueTypeFontCache::GlyphAtlas::Clear()
+{
+	this->pages.clear();
+	this->page_used = PAGE_SIZE;
+}
+
+void *TrueTypeFontCache::GlyphAtlas::AllocatePtr(size_t size)
+{
+	size = Align(size, alignof(std::max_align_t));
+
+	/* Huge glyphs get a page of their own, before the page that is being filled. */
+	if (size > PAGE_SIZE / 4) {
+		auto it = this->pages.emplace(this->pages.empty() ? this->pages.end() : std::prev(this->pages.end()), std::make_unique<std::byte[]>(size));
+		return it->get();
+	}
+
+	if (this->page_used + size > PAGE_SIZE) {
+		this->pages.push_back(std::make_unique<std::byte[]>(PAGE_SIZE));
+		this->page_used = 0;
+	}
+
+	std::byte *ptr = this->pages.back().get() + this->page_used;
+	this->page_used += size;
+	return ptr;
+}
 
 TrueTypeFontCache::GlyphEntry *TrueTypeFontCache::GetGlyphPtr(GlyphID key)
 {
+	if (key <= MAX_INDEXED_GLYPH) {
+		if (key >= this->glyph_index.size()) return nullptr;
+		return &this->glyph_index[key];
+	}
+
 	auto found = this->glyph_to_sprite_map.find(key);
 	if (found == std::end(this->glyph_to_sprite_map)) return nullptr;
 	return &found->second;
@@ -53,8 +89,12 @@ TrueTypeFontCache::GlyphEntry *TrueTypeFontCache::GetGlyphPtr(GlyphID key)
 
 TrueTypeFontCache::GlyphEntry &TrueTypeFontCache::SetGlyphPtr(GlyphID key, GlyphEntry &&glyph)
 {
-	this->glyph_to_sprite_map[key] = std::move(glyph);
-	return this->glyph_to_sprite_map[key];
+	if (key <= MAX_INDEXED_GLYPH) {
+		if (key >= this->glyph_index.size()) this->glyph_index.resize(key + 1);
+		return this->glyph_index[key] = std::move(glyph);
+	}
+
+	return this->glyph_to_sprite_map[key] = std::move(glyph);
 }
 
 bool TrueTypeFontCache::GetDrawGlyphShadow()
@@ -67,7 +107,7 @@ uint TrueTypeFontCache::GetGlyphWidth(GlyphID key)
 	if ((key & SPRITE_GLYPH) != 0) return this->parent->GetGlyphWidth(key);
 
 	GlyphEntry *glyph = this->GetGlyphPtr(key);
-	if (glyph == nullptr || glyph->data == nullptr) {
+	if (glyph == nullptr || glyph->sprite == nullptr) {
 		this->GetGlyph(key);
 		glyph = this->GetGlyphPtr(key);
 	}
@@ -81,7 +121,7 @@ const Sprite *TrueTypeFontCache::GetGlyph(GlyphID key)
 
 	/* Check for the glyph in our cache */
 	GlyphEntry *glyph = this->GetGlyphPtr(key);
-	if (glyph != nullptr && glyph->data != nullptr) return glyph->GetSprite();
+	if (glyph != nullptr && glyph->sprite != nullptr) return glyph->GetSprite();
 
 	return this->InternalGetGlyph(key, GetFontAAState());
 }
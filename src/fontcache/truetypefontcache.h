@@ -11,6 +11,7 @@
 #define TRUETYPEFONTCACHE_H
 
 #include "../fontcache.h"
+#include "../spriteloader/spriteloader.hpp"
 
 
 static const int MAX_FONT_SIZE = 72; ///< Maximum font size.
@@ -27,15 +28,38 @@ protected:
 	int req_size = 0; ///< Requested font size.
 	int used_size = 0; ///< Used font size.
 
+	static constexpr GlyphID MAX_INDEXED_GLYPH = 0xFFFF; ///< Highest glyph ID that is looked up by index instead of in the map.
+
 	/** Container for information about a glyph. */
 	struct GlyphEntry {
-		std::unique_ptr<std::byte[]> data; ///< The loaded sprite.
+		Sprite *sprite = nullptr; ///< The loaded sprite, stored in the glyph atlas.
 		uint8_t width = 0; ///< The width of the glyph.
 
-		Sprite *GetSprite() { return reinterpret_cast<Sprite *>(data.get()); }
+		Sprite *GetSprite() { return this->sprite; }
+	};
+
+	/**
+	 * Storage of the sprites of the glyphs, packed into large pages.
+	 * Glyphs are small and are only freed all at once, so one allocation per glyph is a waste of time and memory,
+	 * and spreads the glyphs of a string all over the heap.
+	 */
+	class GlyphAtlas : public SpriteAllocator {
+	public:
+		void Clear();
+
+	protected:
+		void *AllocatePtr(size_t size) override;
+
+	private:
+		static constexpr size_t PAGE_SIZE = 64 * 1024; ///< Size of a page of the atlas.
+
+		std::vector<std::unique_ptr<std::byte[]>> pages{}; ///< Pages of the atlas; the last one is being filled.
+		size_t page_used = PAGE_SIZE; ///< Number of bytes used of the last page.
 	};
 
-	std::unordered_map<GlyphID, GlyphEntry> glyph_to_sprite_map{};
+	GlyphAtlas glyph_atlas{}; ///< Storage of the sprites of the glyphs.
+	std::vector<GlyphEntry> glyph_index{}; ///< Glyphs up to #MAX_INDEXED_GLYPH, indexed by their ID.
+	std::unordered_map<GlyphID, GlyphEntry> glyph_to_sprite_map{}; ///< Glyphs with a higher ID.
 
 	GlyphEntry *GetGlyphPtr(GlyphID key);
 	GlyphEntry &SetGlyphPtr(GlyphID key, GlyphEntry &&glyph);
@@ -12,6 +12,7 @@
 #include "framerate_type.h"
 #include <chrono>
 #include "gfx_func.h"
+#include "spritecache.h"
 #include "newgrf_sound.h"
 #include "window_gui.h"
 #include "window_func.h"
@@ -434,6 +435,7 @@ static constexpr std::initializer_list<NWidgetPart> _framerate_window_widgets =
 			NWidget(WWT_TEXT, Colours::Invalid, WID_FRW_RATE_GAMELOOP), SetToolTip(STR_FRAMERATE_RATE_GAMELOOP_TOOLTIP), SetFill(1, 0), SetResize(1, 0),
 			NWidget(WWT_TEXT, Colours::Invalid, WID_FRW_RATE_DRAWING),  SetToolTip(STR_FRAMERATE_RATE_BLITTER_TOOLTIP), SetFill(1, 0), SetResize(1, 0),
 			NWidget(WWT_TEXT, Colours::Invalid, WID_FRW_RATE_FACTOR), SetToolTip(STR_FRAMERATE_SPEED_FACTOR_TOOLTIP), SetFill(1, 0), SetResize(1, 0),
+			NWidget(WWT_TEXT, Colours::Invalid, WID_FRW_SPRITE_CACHE), SetToolTip(STR_FRAMERATE_SPRITE_CACHE_TOOLTIP), SetFill(1, 0), SetResize(1, 0),
 		EndContainer(),
 	EndContainer(),
 	NWidget(NWID_HORIZONTAL),
@@ -552,6 +554,11 @@ struct FramerateWindow : Window {
 			case WID_FRW_RATE_FACTOR:
 				return GetString(STR_FRAMERATE_SPEED_FACTOR, this->speed_gameloop.GetValue(), this->speed_gameloop.GetDecimals());
 
+			case WID_FRW_SPRITE_CACHE: {
+				const SpriteCacheStatistics &stats = GetSpriteCacheStatistics();
+				return GetString(STR_FRAMERATE_SPRITE_CACHE, stats.hits, stats.misses, stats.evictions);
+			}
+
 			case WID_FRW_INFO_DATA_POINTS:
 				return GetString(STR_FRAMERATE_DATA_POINTS, NUM_FRAMERATE_POINTS);
 
@@ -572,6 +579,9 @@ struct FramerateWindow : Window {
 			case WID_FRW_RATE_FACTOR:
 				size = GetStringBoundingBox(GetString(STR_FRAMERATE_SPEED_FACTOR, GetParamMaxDigits(6), 2));
 				break;
+			case WID_FRW_SPRITE_CACHE:
+				size = GetStringBoundingBox(GetString(STR_FRAMERATE_SPRITE_CACHE, GetParamMaxDigits(9), GetParamMaxDigits(7), GetParamMaxDigits(7)));
+				break;
 
 			case WID_FRW_TIMES_NAMES: {
 				size.width = 0;
@@ -54,7 +54,6 @@ GameSessionStats _game_session_stats; ///< Statistics about the current session.
 static EnumIndexArray<std::array<uint8_t, 244>, FontSize, FontSize::End> _stringwidth_table; ///< Cache containing width of often used characters. @see GetCharacterWidth()
 DrawPixelInfo *_cur_dpi;
 
-static void GfxMainBlitterViewport(const Sprite *sprite, int x, int y, BlitterMode mode, const SubSprite *sub = nullptr, SpriteID sprite_id = SPR_CURSOR_MOUSE);
 static void GfxMainBlitter(const Sprite *sprite, int x, int y, BlitterMode mode, const SubSprite *sub = nullptr, SpriteID sprite_id = SPR_CURSOR_MOUSE, ZoomLevel zoom = ZoomLevel::Min);
 
 static ReusableBuffer<uint8_t> _cursor_backup;
@@ -83,6 +82,10 @@ static size_t _dirty_blocks_per_column = 0;
 static std::vector<uint8_t> _dirty_blocks;
 extern uint _dirty_block_colour;
 
+static const int64_t DIRTY_RECT_OVERHEAD = 8192; ///< Fixed cost of redrawing a rectangle, in pixels that could be redrawn instead.
+static std::vector<Rect> _dirty_rects; ///< Rectangles being redrawn by #DrawDirtyBlocks.
+DirtyRedrawStats *_dirty_redraw_stats = nullptr; ///< Statistics to update when redrawing the dirty parts, if any.
+
 void GfxScroll(int left, int top, int width, int height, int xo, int yo)
 {
 	Blitter *blitter = BlitterFactory::GetCurrentBlitter();
@@ -470,20 +473,30 @@ void DrawRectOutline(const Rect &r, PixelColour colour, int width, int dash)
 }
 
 /**
- * Set the colour remap to be for the given colour.
- * @param colour the new colour of the remap.
+ * Fill a colour remap for drawing in the given colour.
+ * @param colour The colour.
+ * @param[out] remap The remap to fill; the first entry is left alone.
  */
-static void SetColourRemap(ExtendedTextColour colour)
+static void FillColourRemap(ExtendedTextColour colour, std::span<uint8_t, 3> remap)
 {
-	if (colour == TextColour::Invalid) return;
-
 	/* Black strings have no shading ever; the shading is black, so it
 	 * would be invisible at best, but it actually makes it illegible. */
 	bool no_shade = colour.flags.Test(ExtendedTextColourFlag::NoShade) || colour.colour == TextColour::Black;
 	bool raw_colour = colour.flags.Test(ExtendedTextColourFlag::IsPaletteColour);
 
-	_string_colourremap[1] = raw_colour ? to_underlying(colour.colour) : _string_colourmap[to_underlying(colour.colour)].p;
-	_string_colourremap[2] = no_shade ? 0 : 1;
+	remap[1] = raw_colour ? to_underlying(colour.colour) : _string_colourmap[to_underlying(colour.colour)].p;
+	remap[2] = no_shade ? 0 : 1;
+}
+
+/**
+ * Set the colour remap to be for the given colour.
+ * @param colour the new colour of the remap.
+ */
+static void SetColourRemap(ExtendedTextColour colour)
+{
+	if (colour == TextColour::Invalid) return;
+
+	FillColourRemap(colour, _string_colourremap);
 	_colour_remap_ptr = _string_colourremap;
 }
 
@@ -999,30 +1012,31 @@ static BlitterMode GetBlitterMode(PaletteID pal)
 }
 
 /**
- * Draw a sprite in a viewport.
+ * Look up the sprite data and colour remap to draw a sprite in a viewport with.
  * @param img  Image number to draw
  * @param pal  Palette to use.
  * @param x    Left coordinate of image in viewport, scaled by zoom
  * @param y    Top coordinate of image in viewport, scaled by zoom
  * @param sub  If available, draw only specified part of the sprite
+ * @return The sprite, ready to be drawn with #DrawPreparedSpriteViewport.
  */
-void DrawSpriteViewport(SpriteID img, PaletteID pal, int x, int y, const SubSprite *sub)
+PreparedViewportSprite PrepareSpriteViewport(SpriteID img, PaletteID pal, int x, int y, const SubSprite *sub)
 {
-	SpriteID real_sprite = GB(img, 0, SPRITE_WIDTH);
+	PreparedViewportSprite prepared{GetSprite(GB(img, 0, SPRITE_WIDTH), SpriteType::Normal), _colour_remap_ptr, img, pal, x, y, sub, {}};
 	if (HasBit(img, PALETTE_MODIFIER_TRANSPARENT)) {
-		pal = GB(pal, 0, PALETTE_WIDTH);
-		_colour_remap_ptr = GetNonSprite(pal, SpriteType::Recolour) + 1;
-		GfxMainBlitterViewport(GetSprite(real_sprite, SpriteType::Normal), x, y, pal == PALETTE_TO_TRANSPARENT ? BlitterMode::Transparent : BlitterMode::TransparentRemap, sub, real_sprite);
+		prepared.remap = GetNonSprite(GB(pal, 0, PALETTE_WIDTH), SpriteType::Recolour) + 1;
 	} else if (pal != PAL_NONE) {
 		if (HasBit(pal, PALETTE_TEXT_RECOLOUR)) {
-			SetColourRemap((TextColour)GB(pal, 0, PALETTE_WIDTH));
+			ExtendedTextColour colour = (TextColour)GB(pal, 0, PALETTE_WIDTH);
+			if (colour != TextColour::Invalid) {
+				FillColourRemap(colour, prepared.text_remap);
+				prepared.remap = nullptr;
+			}
 		} else {
-			_colour_remap_ptr = GetNonSprite(GB(pal, 0, PALETTE_WIDTH), SpriteType::Recolour) + 1;
+			prepared.remap = GetNonSprite(GB(pal, 0, PALETTE_WIDTH), SpriteType::Recolour) + 1;
 		}
-		GfxMainBlitterViewport(GetSprite(real_sprite, SpriteType::Normal), x, y, GetBlitterMode(pal), sub, real_sprite);
-	} else {
-		GfxMainBlitterViewport(GetSprite(real_sprite, SpriteType::Normal), x, y, BlitterMode::Normal, sub, real_sprite);
 	}
+	return prepared;
 }
 
 /**
@@ -1062,12 +1076,13 @@ void DrawSprite(SpriteID img, PaletteID pal, int x, int y, const SubSprite *sub,
  * @param sub Whether to only draw a sub set of the sprite.
  * @param sprite_id The unique identifier of the sprite for NewGRF debug purposes.
  * @param zoom The zoom level at which to draw the sprites.
+ * @param remap The colour remap to use.
  * @param dst Optional parameter for a different blitting destination.
  * @tparam ZOOM_BASE The factor required to get the sub sprite information into the right size.
  * @tparam SCALED_XY Whether the X and Y are scaled or unscaled.
  */
 template <int ZOOM_BASE, bool SCALED_XY>
-static void GfxBlitter(const Sprite * const sprite, int x, int y, BlitterMode mode, const SubSprite * const sub, SpriteID sprite_id, ZoomLevel zoom, const DrawPixelInfo *dst = nullptr)
+static void GfxBlitter(const Sprite * const sprite, int x, int y, BlitterMode mode, const SubSprite * const sub, SpriteID sprite_id, ZoomLevel zoom, const uint8_t *remap, const DrawPixelInfo *dst = nullptr)
 {
 	const DrawPixelInfo *dpi = (dst != nullptr) ? dst : _cur_dpi;
 	Blitter::BlitterParams bp;
@@ -1116,7 +1131,7 @@ static void GfxBlitter(const Sprite * const sprite, int x, int y, BlitterMode mo
 
 	bp.dst = dpi->dst_ptr;
 	bp.pitch = dpi->pitch;
-	bp.remap = _colour_remap_ptr;
+	bp.remap = remap;
 
 	assert(sprite->width > 0);
 	assert(sprite->height > 0);
@@ -1228,7 +1243,7 @@ std::unique_ptr<uint32_t[]> DrawSpriteToRgbaBuffer(SpriteID spriteId, ZoomLevel
 
 	/* Temporarily disable screen animations while blitting - This prevents 40bpp_anim from writing to the animation buffer. */
 	Backup<bool> disable_anim(_screen_disable_anim, true);
-	GfxBlitter<1, true>(sprite, 0, 0, BlitterMode::Normal, nullptr, real_sprite, zoom, &dpi);
+	GfxBlitter<1, true>(sprite, 0, 0, BlitterMode::Normal, nullptr, real_sprite, zoom, _colour_remap_ptr, &dpi);
 	disable_anim.Restore();
 
 	if (blitter->GetScreenDepth() == 8) {
@@ -1243,14 +1258,27 @@ std::unique_ptr<uint32_t[]> DrawSpriteToRgbaBuffer(SpriteID spriteId, ZoomLevel
 	return result;
 }
 
-static void GfxMainBlitterViewport(const Sprite *sprite, int x, int y, BlitterMode mode, const SubSprite *sub, SpriteID sprite_id)
+/**
+ * Draw a prepared sprite in a viewport.
+ * @param sprite The sprite to draw.
+ * @param dpi    The part of the viewport to draw to.
+ */
+void DrawPreparedSpriteViewport(const PreparedViewportSprite &sprite, const DrawPixelInfo *dpi)
 {
-	GfxBlitter<ZOOM_BASE, false>(sprite, x, y, mode, sub, sprite_id, _cur_dpi->zoom);
+	const uint8_t *remap = sprite.remap != nullptr ? sprite.remap : sprite.text_remap.data();
+	SpriteID real_sprite = GB(sprite.image, 0, SPRITE_WIDTH);
+	BlitterMode mode;
+	if (HasBit(sprite.image, PALETTE_MODIFIER_TRANSPARENT)) {
+		mode = GB(sprite.pal, 0, PALETTE_WIDTH) == PALETTE_TO_TRANSPARENT ? BlitterMode::Transparent : BlitterMode::TransparentRemap;
+	} else {
+		mode = GetBlitterMode(sprite.pal);
+	}
+	GfxBlitter<ZOOM_BASE, false>(sprite.sprite, sprite.x, sprite.y, mode, sprite.sub, real_sprite, dpi->zoom, remap, dpi);
 }
 
 static void GfxMainBlitter(const Sprite *sprite, int x, int y, BlitterMode mode, const SubSprite *sub, SpriteID sprite_id, ZoomLevel zoom)
 {
-	GfxBlitter<1, true>(sprite, x, y, mode, sub, sprite_id, zoom);
+	GfxBlitter<1, true>(sprite, x, y, mode, sub, sprite_id, zoom, _colour_remap_ptr);
 }
 
 /**
@@ -1446,17 +1474,64 @@ void RedrawScreenRect(int left, int top, int right, int bottom)
 	VideoDriver::GetInstance()->MakeDirty(left, top, right - left, bottom - top);
 }
 
+/**
+ * Merge rectangles that need redrawing when redrawing their bounding box is cheaper than redrawing them one by one.
+ * Redrawing a rectangle costs its area, plus a fixed overhead for finding the windows in it and, for
+ * viewports, collecting the sprites around it. Rectangles only get bigger, so nothing is left out.
+ * @param[in,out] rects The rectangles to redraw.
+ * @param overhead The fixed cost of redrawing a rectangle, in pixels.
+ */
+void CoalesceDirtyRects(std::vector<Rect> &rects, int64_t overhead)
+{
+	auto area = [](const Rect &r) -> int64_t { return static_cast<int64_t>(r.Width()) * r.Height(); };
+	auto is_merged = [](const Rect &r) { return r.left > r.right; };
+
+	std::ranges::sort(rects, [](const Rect &a, const Rect &b) { return std::tie(a.top, a.left) < std::tie(b.top, b.left); });
+
+	bool merged;
+	do {
+		merged = false;
+		for (size_t i = 0; i < rects.size(); i++) {
+			Rect &r = rects[i];
+			if (is_merged(r)) continue;
+
+			for (size_t j = i + 1; j < rects.size(); j++) {
+				Rect &other = rects[j];
+				/* The rectangles are sorted by top, and a gap between them costs at least its height times the width of 'r'. */
+				if (other.top - r.bottom - 1 > overhead / r.Width()) break;
+				if (is_merged(other)) continue;
+
+				Rect bounds{std::min(r.left, other.left), r.top, std::max(r.right, other.right), std::max(r.bottom, other.bottom)};
+				if (area(bounds) > area(r) + area(other) + overhead) continue;
+
+				r = bounds;
+				other.left = other.right + 1;
+				merged = true;
+			}
+		}
+		/* A grown rectangle may now cover an earlier one, so try again till nothing changes. */
+		std::erase_if(rects, is_merged);
+	} while (merged);
+}
+
 /**
  * Repaints the rectangle blocks which are marked as 'dirty'.
  *
+ * Adjacent dirty blocks are combined to rectangles, and rectangles close to each other are
+ * combined further as long as that is cheaper. The windows then repaint all their rectangles
+ * after each other.
+ *
  * @see AddDirtyBlock
+ * @see CoalesceDirtyRects
  *
  * @ingroup dirty
  */
 void DrawDirtyBlocks()
 {
+	auto start = std::chrono::steady_clock::now();
 	auto is_dirty = [](auto block) -> bool { return block != 0; };
 	auto block = _dirty_blocks.begin();
+	_dirty_rects.clear();
 
 	for (size_t x = 0; x < _dirty_blocks_per_row; ++x) {
 		auto last_of_column = block + _dirty_blocks_per_column;
@@ -1493,11 +1568,38 @@ void DrawDirtyBlocks()
 			bottom = std::min(_invalid_rect.bottom, bottom);
 
 			if (left < right && top < bottom) {
-				RedrawScreenRect(left, top, right, bottom);
+				_dirty_rects.emplace_back(left, top, right - 1, bottom - 1);
 			}
 		}
 	}
 
+	CoalesceDirtyRects(_dirty_rects, DIRTY_RECT_OVERHEAD);
+
+	if (!_dirty_rects.empty()) {
+		if (_cursor.visible) {
+			auto under_cursor = [](const Rect &r) {
+				return r.right >= _cursor.draw_pos.x && r.left < _cursor.draw_pos.x + _cursor.draw_size.x &&
+						r.bottom >= _cursor.draw_pos.y && r.top < _cursor.draw_pos.y + _cursor.draw_size.y;
+			};
+			if (std::ranges::any_of(_dirty_rects, under_cursor)) UndrawMouseCursor();
+		}
+
+		if (_networking) NetworkUndrawChatMessage();
+
+		DrawOverlappedWindowForAll(_dirty_rects);
+
+		for (const Rect &r : _dirty_rects) {
+			VideoDriver::GetInstance()->MakeDirty(r.left, r.top, r.Width(), r.Height());
+		}
+	}
+
+	if (_dirty_redraw_stats != nullptr) {
+		_dirty_redraw_stats->calls++;
+		_dirty_redraw_stats->rects += _dirty_rects.size();
+		for (const Rect &r : _dirty_rects) _dirty_redraw_stats->pixels += static_cast<uint64_t>(r.Width()) * r.Height();
+		_dirty_redraw_stats->time += std::chrono::steady_clock::now() - start;
+	}
+
 	++_dirty_block_colour;
 	_invalid_rect.left = _screen.width;
 	_invalid_rect.top = _screen.height;
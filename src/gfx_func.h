@@ -44,6 +44,8 @@
 #include "strings_type.h"
 #include "string_type.h"
 
+#include <chrono>
+
 void GameLoop();
 
 void CreateConsole();
@@ -86,12 +88,30 @@ bool AdjustGUIZoom(bool automatic);
 void UndrawMouseCursor();
 
 void RedrawScreenRect(int left, int top, int right, int bottom);
+void CoalesceDirtyRects(std::vector<Rect> &rects, int64_t overhead);
 void GfxScroll(int left, int top, int width, int height, int xo, int yo);
 
 Dimension GetSpriteSize(SpriteID sprid, Point *offset = nullptr, ZoomLevel zoom = _gui_zoom);
 Dimension GetScaledSpriteSize(SpriteID sprid); /* widget.cpp */
 Dimension GetSquareScaledSpriteSize(SpriteID sprid); /* widget.cpp */
-void DrawSpriteViewport(SpriteID img, PaletteID pal, int x, int y, const SubSprite *sub = nullptr);
+
+/**
+ * A sprite of a viewport together with the sprite data and colour remap it is drawn with.
+ * Blitting a prepared sprite does not access the sprite cache, so it can be done on any thread.
+ */
+struct PreparedViewportSprite {
+	const struct Sprite *sprite; ///< The sprite data.
+	const uint8_t *remap; ///< The colour remap, or \c nullptr to use #text_remap.
+	SpriteID image; ///< Image number with its modifiers.
+	PaletteID pal; ///< Palette the image is drawn with.
+	int x; ///< Left coordinate of the image in the viewport, scaled by zoom.
+	int y; ///< Top coordinate of the image in the viewport, scaled by zoom.
+	const SubSprite *sub; ///< Part of the sprite to draw, or \c nullptr to draw all of it.
+	std::array<uint8_t, 3> text_remap; ///< Colour remap for images recoloured like text.
+};
+
+PreparedViewportSprite PrepareSpriteViewport(SpriteID img, PaletteID pal, int x, int y, const SubSprite *sub = nullptr);
+void DrawPreparedSpriteViewport(const PreparedViewportSprite &sprite, const DrawPixelInfo *dpi);
 void DrawSprite(SpriteID img, PaletteID pal, int x, int y, const SubSprite *sub = nullptr, ZoomLevel zoom = _gui_zoom);
 void DrawSpriteIgnorePadding(SpriteID img, PaletteID pal, const Rect &r, Alignment align); /* widget.cpp */
 std::unique_ptr<uint32_t[]> DrawSpriteToRgbaBuffer(SpriteID spriteId, ZoomLevel zoom = _gui_zoom);
@@ -216,6 +236,17 @@ inline bool FillDrawPixelInfo(DrawPixelInfo *n, const Rect &r)
 
 /* window.cpp */
 void DrawOverlappedWindowForAll(int left, int top, int right, int bottom);
+void DrawOverlappedWindowForAll(std::span<const Rect> rects);
+
+/** Statistics of redrawing the dirty parts of the screen, for benchmarking. */
+struct DirtyRedrawStats {
+	uint64_t calls = 0; ///< Number of times the dirty parts were redrawn.
+	uint64_t rects = 0; ///< Number of rectangles that were redrawn.
+	uint64_t pixels = 0; ///< Number of pixels that were redrawn.
+	std::chrono::steady_clock::duration time{}; ///< Time spent redrawing.
+};
+
+extern DirtyRedrawStats *_dirty_redraw_stats;
 
 void SetMouseCursorBusy(bool busy);
 void SetMouseCursor(CursorID cursor, PaletteID pal);
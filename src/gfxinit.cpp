@@ -21,6 +21,7 @@
 #include "base_media_func.h"
 #include "base_media_graphics.h"
 #include "base_media_sounds.h"
+#include "spritecache_disk.h"
 
 #include "table/sprites.h"
 
@@ -37,17 +38,19 @@ static constexpr std::span<const std::pair<SpriteID, SpriteID>> _landscape_sprit
 
 /**
  * Load an old fashioned GRF file.
- * @param filename   The name of the file to open.
+ * @param grf        The file to open.
  * @param load_index The offset of the first sprite.
  * @param needs_palette_remap Whether the colours in the GRF file need a palette remap.
  * @return The number of loaded sprites.
  */
-static uint LoadGrfFile(const std::string &filename, SpriteID load_index, bool needs_palette_remap)
+static uint LoadGrfFile(const MD5File &grf, SpriteID load_index, bool needs_palette_remap)
 {
 	SpriteID load_index_org = load_index;
 	SpriteID sprite_id = 0;
+	const std::string &filename = grf.filename;
 
 	SpriteFile &file = OpenCachedSpriteFile(filename, Subdirectory::Baseset, needs_palette_remap);
+	file.SetContentHash(GetSpriteDiskCacheFileHash(Subdirectory::Baseset, filename));
 
 	Debug(sprite, 2, "Reading grf-file '{}'", filename);
 
@@ -74,15 +77,17 @@ static uint LoadGrfFile(const std::string &filename, SpriteID load_index, bool n
 
 /**
  * Load an old fashioned GRF file to replace already loaded sprites.
- * @param filename   The name of the file to open.
+ * @param grf        The file to open.
  * @param index_tbl  The offsets of each of the sprites.
  * @param needs_palette_remap Whether the colours in the GRF file need a palette remap.
  */
-static void LoadGrfFileIndexed(const std::string &filename, std::span<const std::pair<SpriteID, SpriteID>> index_tbl, bool needs_palette_remap)
+static void LoadGrfFileIndexed(const MD5File &grf, std::span<const std::pair<SpriteID, SpriteID>> index_tbl, bool needs_palette_remap)
 {
 	uint sprite_id = 0;
+	const std::string &filename = grf.filename;
 
 	SpriteFile &file = OpenCachedSpriteFile(filename, Subdirectory::Baseset, needs_palette_remap);
+	file.SetContentHash(GetSpriteDiskCacheFileHash(Subdirectory::Baseset, filename));
 
 	Debug(sprite, 2, "Reading indexed grf-file '{}'", filename);
 
@@ -172,7 +177,7 @@ static void LoadSpriteTables()
 {
 	const GraphicsSet *used_set = BaseGraphics::GetUsedSet();
 
-	LoadGrfFile(used_set->files[to_underlying(GraphicsFileType::Base)].filename, 0, PaletteType::DOS != used_set->palette);
+	LoadGrfFile(used_set->files[to_underlying(GraphicsFileType::Base)], 0, PaletteType::DOS != used_set->palette);
 
 	/*
 	 * The second basic file always starts at the given location and does
@@ -180,7 +185,7 @@ static void LoadSpriteTables()
 	 * has a few sprites less. However, we do not care about those missing
 	 * sprites as they are not shown anyway (logos in intro game).
 	 */
-	LoadGrfFile(used_set->files[to_underlying(GraphicsFileType::Logos)].filename, 4793, PaletteType::DOS != used_set->palette);
+	LoadGrfFile(used_set->files[to_underlying(GraphicsFileType::Logos)], 4793, PaletteType::DOS != used_set->palette);
 
 	/*
 	 * Load additional sprites for climates other than temperate.
@@ -189,7 +194,7 @@ static void LoadSpriteTables()
 	 */
 	if (_settings_game.game_creation.landscape != LandscapeType::Temperate) {
 		LoadGrfFileIndexed(
-			used_set->files[to_underlying(GraphicsFileType::Arctic) + to_underlying(_settings_game.game_creation.landscape) - 1].filename,
+			used_set->files[to_underlying(GraphicsFileType::Arctic) + to_underlying(_settings_game.game_creation.landscape) - 1],
 			_landscape_spriteindexes[to_underlying(_settings_game.game_creation.landscape) - 1],
 			PaletteType::DOS != used_set->palette
 		);
@@ -285,9 +290,11 @@ static bool SwitchNewGRFBlitter()
 		{ "8bpp-optimized",  2,  8,  8,  8,  8 },
 		{ "40bpp-anim",      2,  8, 32,  8, 32 },
 #ifdef WITH_SSE
+		{ "32bpp-avx2",      0, 32, 32,  8, 32 },
 		{ "32bpp-sse4",      0, 32, 32,  8, 32 },
 		{ "32bpp-ssse3",     0, 32, 32,  8, 32 },
 		{ "32bpp-sse2",      0, 32, 32,  8, 32 },
+		{ "32bpp-avx2-anim", 1, 32, 32,  8, 32 },
 		{ "32bpp-sse4-anim", 1, 32, 32,  8, 32 },
 #endif
 		{ "32bpp-optimized", 0,  8, 32,  8, 32 },
@@ -691,55 +691,54 @@ static void AnimateMineTower(TileIndex tile)
 }
 
 /** @copydoc AnimateTileProc */
-static void AnimateTile_Industry(TileIndex tile)
+static uint AnimateTile_Industry(TileIndex tile)
 {
 	IndustryGfx gfx = GetIndustryGfx(tile);
 
-	if (GetIndustryTileSpec(gfx)->animation.status != AnimationStatus::NoAnimation) {
-		AnimateNewIndustryTile(tile);
-		return;
-	}
+	if (GetIndustryTileSpec(gfx)->animation.status != AnimationStatus::NoAnimation) return AnimateNewIndustryTile(tile);
 
 	switch (gfx) {
 	case GFX_SUGAR_MINE_SIEVE:
 		if ((TimerGameTick::counter & 1) == 0) AnimateSugarSieve(tile);
-		break;
+		return GetAnimationWait(2);
 
 	case GFX_TOFFEE_QUARRY:
 		if ((TimerGameTick::counter & 3) == 0) AnimateToffeeQuarry(tile);
-		break;
+		return GetAnimationWait(4);
 
 	case GFX_BUBBLE_CATCHER:
 		if ((TimerGameTick::counter & 1) == 0) AnimateBubbleCatcher(tile);
-		break;
+		return GetAnimationWait(2);
 
 	case GFX_POWERPLANT_SPARKS:
 		if ((TimerGameTick::counter & 3) == 0) AnimatePowerPlantSparks(tile);
-		break;
+		return GetAnimationWait(4);
 
 	case GFX_TOY_FACTORY:
 		if ((TimerGameTick::counter & 1) == 0) AnimateToyFactory(tile);
-		break;
+		return GetAnimationWait(2);
 
 	case GFX_PLASTIC_FOUNTAIN_ANIMATED_1: case GFX_PLASTIC_FOUNTAIN_ANIMATED_2:
 	case GFX_PLASTIC_FOUNTAIN_ANIMATED_3: case GFX_PLASTIC_FOUNTAIN_ANIMATED_4:
 	case GFX_PLASTIC_FOUNTAIN_ANIMATED_5: case GFX_PLASTIC_FOUNTAIN_ANIMATED_6:
 	case GFX_PLASTIC_FOUNTAIN_ANIMATED_7: case GFX_PLASTIC_FOUNTAIN_ANIMATED_8:
 		if ((TimerGameTick::counter & 3) == 0) AnimatePlasticFountain(tile, gfx);
-		break;
+		return GetAnimationWait(4);
 
 	case GFX_OILWELL_ANIMATED_1:
 	case GFX_OILWELL_ANIMATED_2:
 	case GFX_OILWELL_ANIMATED_3:
 		if ((TimerGameTick::counter & 7) == 0) AnimateOilWell(tile, gfx);
-		break;
+		return GetAnimationWait(8);
 
 	case GFX_COAL_MINE_TOWER_ANIMATED:
 	case GFX_COPPER_MINE_TOWER_ANIMATED:
 	case GFX_GOLD_MINE_TOWER_ANIMATED:
 		AnimateMineTower(tile);
-		break;
+		return 1;
 	}
+
+	return 1;
 }
 
 static void CreateChimneySmoke(TileIndex tile)
@@ -861,6 +860,7 @@ static void TileLoop_Industry(TileIndex tile)
 			SetIndustryCompleted(tile);
 			SetIndustryGfx(tile, newgfx);
 			MarkTileDirtyByTile(tile);
+			RescheduleAnimatedTile(tile);
 			return;
 		}
 	}
@@ -872,6 +872,7 @@ static void TileLoop_Industry(TileIndex tile)
 		ResetIndustryConstructionStage(tile);
 		SetIndustryGfx(tile, newgfx);
 		MarkTileDirtyByTile(tile);
+		RescheduleAnimatedTile(tile);
 		return;
 	}
 
@@ -21,6 +21,7 @@
 #include "newgrf_engine.h"
 #include "newgrf_text.h"
 #include "spritecache.h"
+#include "spritecache_disk.h"
 #include "currency_func.h"
 #include "landscape.h"
 #include "newgrf_badge.h"
@@ -40,6 +41,7 @@
 #include "genworld.h"
 #include "error_func.h"
 #include "vehicle_base.h"
+#include "worker_pool.h"
 #include "road.h"
 #include "newgrf_roadstop.h"
 #include "newgrf/newgrf_bytereader.h"
@@ -1416,7 +1418,10 @@ void LoadNewGRFFile(GRFConfig &config, GrfLoadingStage stage, Subdirectory subdi
 		SpriteFile temporarySpriteFile(filename, subdir, needs_palette_remap);
 		LoadNewGRFFileFromFile(config, stage, temporarySpriteFile);
 	} else {
-		LoadNewGRFFileFromFile(config, stage, OpenCachedSpriteFile(filename, subdir, needs_palette_remap));
+		SpriteFile &file = OpenCachedSpriteFile(filename, subdir, needs_palette_remap);
+		/* The file is loaded once for every stage, but it only needs to be looked up once. */
+		if (file.GetContentHash() == MD5Hash{}) file.SetContentHash(GetSpriteDiskCacheFileHash(subdir, filename));
+		LoadNewGRFFileFromFile(config, stage, file);
 	}
 }
 
@@ -1636,6 +1641,9 @@ static void AfterLoadGRFs()
 	/* Cached callback groups are no longer needed. */
 	ResetCallbacks(true);
 
+	/* All procedures are complete now, so the sprite groups can be compiled. */
+	CompileSpriteGroups();
+
 	FinaliseStringMapping();
 
 	/* Clear the action 6 override sprites. */
@@ -1752,6 +1760,55 @@ static void AfterLoadGRFs()
 	_grm_sprites.clear();
 }
 
+/**
+ * Index the files of the NewGRFs that are going to be loaded, spread over the worker threads.
+ * The loading stages then skip the compressed sprites and read the sprite sections
+ * without decoding them again for every stage.
+ * @param num_baseset Number of NewGRFs at the front of the list to look up in the baseset dir instead of the newgrf dir.
+ */
+static void IndexNewGRFFiles(uint num_baseset)
+{
+	/** A file that still needs to be indexed. */
+	struct IndexJob {
+		SpriteFile *file; ///< The cached sprite file to give the index.
+		Subdirectory subdir; ///< The sub directory to find the file in.
+		std::unique_ptr<SpriteFileIndex> index; ///< The built index.
+	};
+	std::vector<IndexJob> jobs;
+
+	/* Count the files the same way as LoadNewGRF does, so each is looked up in the same sub directory. */
+	uint num_grfs = 0;
+	uint num_non_static = 0;
+	for (const auto &c : _grfconfig) {
+		if (c->status == GRFStatus::Disabled || c->status == GRFStatus::NotFound) continue;
+
+		Subdirectory subdir = num_grfs < num_baseset ? Subdirectory::Baseset : Subdirectory::NewGrf;
+		if (!FioCheckFileExists(c->filename, subdir)) continue;
+
+		if (!c->flags.Test(GRFConfigFlag::Static) && !c->flags.Test(GRFConfigFlag::System)) {
+			if (num_non_static == NETWORK_MAX_GRF_COUNT) continue;
+			num_non_static++;
+		}
+
+		num_grfs++;
+
+		/* GfxInitSpriteMem drops the cached sprite files before each load, so only a file that is in the list twice is already known. */
+		SpriteFile &file = OpenCachedSpriteFile(c->filename, subdir, c->palette & GRFP_USE_MASK);
+		if (file.GetIndex() != nullptr || std::ranges::any_of(jobs, [&file](const IndexJob &job) { return job.file == &file; })) continue;
+		jobs.push_back({&file, subdir, nullptr});
+	}
+
+	/* The cached files are used by the main thread, so each worker opens the file itself. */
+	RunOnWorkers(jobs.size(), [&jobs](size_t index) {
+		IndexJob &job = jobs[index];
+		SpriteFile file(job.file->GetFilename(), job.subdir, job.file->NeedsPaletteRemap());
+		job.index = BuildSpriteFileIndex(file);
+	});
+
+	for (IndexJob &job : jobs) job.file->SetIndex(std::move(job.index));
+	Debug(grf, 2, "IndexNewGRFFiles: Indexed {} files", jobs.size());
+}
+
 /**
  * Load all the NewGRFs.
  * @param load_index The offset for the first sprite to add.
@@ -1804,6 +1861,8 @@ void LoadNewGRF(SpriteID load_index, uint num_baseset)
 
 	_cur_gps.spriteid = load_index;
 
+	IndexNewGRFFiles(num_baseset);
+
 	/* Load newgrf sprites
 	 * in each loading stage, (try to) open each file specified in the config
 	 * and load information from it. */
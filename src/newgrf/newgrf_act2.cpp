@@ -256,6 +256,8 @@ bool ReadSpriteLayout(ByteReader &buf, uint num_building_sprites, bool use_cur_s
 			regs.max_sprite_offset = max_sprite_offset[i];
 			regs.max_palette_offset = max_palette_offset[i];
 		}
+
+		dts->Compile();
 	}
 
 	return false;
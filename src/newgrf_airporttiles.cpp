@@ -222,6 +222,8 @@ AirportTileResolverObject::AirportTileResolverObject(const AirportTileSpec *ats,
 		tiles_scope(*this, ats, tile, st),
 		airport_scope(*this, tile, st, st != nullptr ? AirportSpec::Get(st->airport.type) : nullptr, st != nullptr ? st->airport.layout : 0)
 {
+	this->fixed_scopes[VarSpriteGroupScope::Self] = &this->tiles_scope;
+	this->fixed_scopes[VarSpriteGroupScope::Parent] = &this->airport_scope;
 	this->root_spritegroup = ats->grf_prop.GetSpriteGroup(st != nullptr);
 }
 
@@ -297,12 +299,12 @@ struct AirportTileAnimationBase : public AnimationBase<AirportTileAnimationBase,
 	static constexpr AirportTileCallbackMask cbm_animation_next_frame = AirportTileCallbackMask::AnimationNextFrame;
 };
 
-void AnimateAirportTile(TileIndex tile)
+uint AnimateAirportTile(TileIndex tile)
 {
 	const AirportTileSpec *ats = AirportTileSpec::GetByTile(tile);
-	if (ats == nullptr) return;
+	if (ats == nullptr) return 1;
 
-	AirportTileAnimationBase::AnimateTile(ats, Station::GetByTile(tile), tile, HasBit(ats->animation_special_flags, 0));
+	return AirportTileAnimationBase::AnimateTile(ats, Station::GetByTile(tile), tile, HasBit(ats->animation_special_flags, 0));
 }
 
 static bool DoTriggerAirportTileAnimation(Station *st, TileIndex tile, AirportAnimationTrigger trigger, uint32_t random, uint32_t var18_extra = 0)
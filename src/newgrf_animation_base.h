@@ -48,8 +48,9 @@ struct AnimationBase {
 	 * @param tile        Tile to animate changes for.
 	 * @param random_animation Whether to pass random bits to the "next frame" callback.
 	 * @param extra_data  Custom extra callback data.
+	 * @return The number of ticks until the tile needs animating again.
 	 */
-	static void AnimateTile(const Tspec *spec, Tobj *obj, TileIndex tile, bool random_animation, Textra extra_data = {})
+	static uint AnimateTile(const Tspec *spec, Tobj *obj, TileIndex tile, bool random_animation, Textra extra_data = {})
 	{
 		assert(spec != nullptr);
 
@@ -66,8 +67,10 @@ struct AnimationBase {
 		/* An animation speed of 2 means the animation frame changes 4 ticks, and
 		 * increasing this value by one doubles the wait. 0 is the minimum value
 		 * allowed for animation_speed, which corresponds to 30ms, and 16 is the
-		 * maximum, corresponding to around 33 minutes. */
-		if (TimerGameTick::counter % (1ULL << animation_speed) != 0) return;
+		 * maximum, corresponding to around 33 minutes. When the speed comes
+		 * from a callback it has to be asked again every tick. */
+		uint wait = spec->callback_mask.Test(Tbase::cbm_animation_speed) ? 1 : GetAnimationWait(1U << animation_speed);
+		if (TimerGameTick::counter % (1ULL << animation_speed) != 0) return wait;
 
 		uint8_t frame      = Tframehelper::Get(obj, tile);
 		uint8_t num_frames = spec->animation.frames;
@@ -114,6 +117,7 @@ struct AnimationBase {
 
 		bool changed = Tframehelper::Set(obj, tile, frame);
 		if (changed) MarkTileDirtyByTile(tile);
+		return wait;
 	}
 
 	/**
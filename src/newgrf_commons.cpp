@@ -584,6 +584,59 @@ void NewGRFSpriteLayout::AllocateRegisters()
 	this->registers.resize(1 + this->seq.size(), {}); // 1 for the ground sprite
 }
 
+/**
+ * Get the value of variable 10 a sprite or palette of a spritelayout is resolved for.
+ * @param explicit_var10  Whether the layout sets the value explicitly.
+ * @param var10           The explicit value.
+ * @param ground          Whether this is the ground sprite.
+ * @param separate_ground Whether the ground sprite shall be resolved by a separate action-1-2-3 chain by default.
+ * @return The value of variable 10.
+ */
+static inline uint8_t GetLayoutVar10(bool explicit_var10, uint8_t var10, bool ground, bool separate_ground)
+{
+	if (explicit_var10) return var10;
+	return ground && separate_ground ? 1 : 0;
+}
+
+/**
+ * Determine which sprites of the spritelayout are changed by action-1-2-3 chains or registers,
+ * and for which values of variable 10 the chains need to be resolved.
+ * Must be called once the registers are read.
+ */
+void NewGRFSpriteLayout::Compile()
+{
+	assert(!this->registers.empty());
+
+	this->dynamic_sprites.clear();
+	this->var10_values = {};
+
+	for (uint i = 0; i < this->registers.size(); i++) {
+		const TileLayoutRegisters &regs = this->registers[i];
+		const PalSpriteID &image = i == 0 ? this->ground : this->seq[i - 1].image;
+		bool ground = i == 0;
+		bool dynamic = false;
+
+		if (HasBit(image.sprite, SPRITE_MODIFIER_CUSTOM_SPRITE) || (regs.flags & TLF_SPRITE_REG_FLAGS)) {
+			for (bool separate_ground : {false, true}) {
+				SetBit(this->var10_values[separate_ground], GetLayoutVar10(regs.flags & TLF_SPRITE_VAR10, regs.sprite_var10, ground, separate_ground));
+			}
+			dynamic = true;
+		}
+
+		if (HasBit(image.pal, SPRITE_MODIFIER_CUSTOM_SPRITE) || (regs.flags & TLF_PALETTE_REG_FLAGS)) {
+			for (bool separate_ground : {false, true}) {
+				SetBit(this->var10_values[separate_ground], GetLayoutVar10(regs.flags & TLF_PALETTE_VAR10, regs.palette_var10, ground, separate_ground));
+			}
+			dynamic = true;
+		}
+
+		if (dynamic) this->dynamic_sprites.push_back(i);
+	}
+}
+
+static const size_t MAX_SPARE_LAYOUT_BUFFERS = 4; ///< Maximum number of buffers to keep for reuse by #SpriteLayoutProcessor.
+static std::vector<std::vector<DrawTileSeqStruct>> _spare_layout_buffers; ///< Buffers of destroyed processors, so drawing a tile does not allocate.
+
 /**
  * Prepares a sprite layout before resolving action-1-2-3 chains.
  * Integrates offsets into the layout and determines which chains to resolve.
@@ -595,8 +648,14 @@ void NewGRFSpriteLayout::AllocateRegisters()
  * @param separate_ground      Whether the ground sprite shall be resolved by a separate action-1-2-3 chain by default.
  */
 SpriteLayoutProcessor::SpriteLayoutProcessor(const NewGRFSpriteLayout &raw_layout, uint32_t orig_offset, uint32_t newgrf_ground_offset, uint32_t newgrf_offset, uint constr_stage, bool separate_ground) :
-	raw_layout(&raw_layout), separate_ground(separate_ground)
+	raw_layout(&raw_layout), var10_values(raw_layout.var10_values[separate_ground]), separate_ground(separate_ground)
 {
+	assert(this->raw_layout->NeedsPreprocessing());
+
+	if (!_spare_layout_buffers.empty()) {
+		this->result_seq = std::move(_spare_layout_buffers.back());
+		_spare_layout_buffers.pop_back();
+	}
 	this->result_seq.reserve(this->raw_layout->seq.size() + 1);
 
 	/* Create a copy of the spritelayout, so we can modify some values.
@@ -607,51 +666,50 @@ SpriteLayoutProcessor::SpriteLayoutProcessor(const NewGRFSpriteLayout &raw_layou
 
 	this->result_seq.insert(this->result_seq.end(), this->raw_layout->seq.begin(), this->raw_layout->seq.end());
 
-	/* Determine the var10 values the action-1-2-3 chains needs to be resolved for,
-	 * and apply the default sprite offsets (unless disabled). */
-	const TileLayoutRegisters *regs = this->raw_layout->registers.empty() ? nullptr : this->raw_layout->registers.data();
+	/* Apply the default sprite offsets (unless disabled).
+	 * The var10 values the action-1-2-3 chains need to be resolved for are known from NewGRFSpriteLayout::Compile. */
+	const TileLayoutRegisters *regs = this->raw_layout->registers.data();
 	bool ground = true;
 	for (DrawTileSeqStruct &result : this->result_seq) {
-		TileLayoutFlags flags = TLF_NOTHING;
-		if (regs != nullptr) flags = regs->flags;
-
-		/* Record var10 value for the sprite */
-		if (HasBit(result.image.sprite, SPRITE_MODIFIER_CUSTOM_SPRITE) || (flags & TLF_SPRITE_REG_FLAGS)) {
-			uint8_t var10 = (flags & TLF_SPRITE_VAR10) ? regs->sprite_var10 : (ground && this->separate_ground ? 1 : 0);
-			SetBit(this->var10_values, var10);
-		}
+		TileLayoutFlags flags = regs->flags;
 
 		/* Add default sprite offset, unless there is a custom one */
 		if (!(flags & TLF_SPRITE)) {
 			if (HasBit(result.image.sprite, SPRITE_MODIFIER_CUSTOM_SPRITE)) {
 				result.image.sprite += ground ? newgrf_ground_offset : newgrf_offset;
-				if (constr_stage > 0 && regs != nullptr) result.image.sprite += GetConstructionStageOffset(constr_stage, regs->max_sprite_offset);
+				if (constr_stage > 0) result.image.sprite += GetConstructionStageOffset(constr_stage, regs->max_sprite_offset);
 			} else {
 				result.image.sprite += orig_offset;
 			}
 		}
 
-		/* Record var10 value for the palette */
-		if (HasBit(result.image.pal, SPRITE_MODIFIER_CUSTOM_SPRITE) || (flags & TLF_PALETTE_REG_FLAGS)) {
-			uint8_t var10 = (flags & TLF_PALETTE_VAR10) ? regs->palette_var10 : (ground && this->separate_ground ? 1 : 0);
-			SetBit(this->var10_values, var10);
-		}
-
 		/* Add default palette offset, unless there is a custom one */
 		if (!(flags & TLF_PALETTE)) {
 			if (HasBit(result.image.pal, SPRITE_MODIFIER_CUSTOM_SPRITE)) {
 				result.image.sprite += ground ? newgrf_ground_offset : newgrf_offset;
-				if (constr_stage > 0 && regs != nullptr) result.image.sprite += GetConstructionStageOffset(constr_stage, regs->max_palette_offset);
+				if (constr_stage > 0) result.image.sprite += GetConstructionStageOffset(constr_stage, regs->max_palette_offset);
 			}
 		}
 
 		ground = false;
-		if (regs != nullptr) regs++;
+		regs++;
 	}
 }
 
+/**
+ * Hand the buffer of the processed layout to the next processor.
+ */
+SpriteLayoutProcessor::~SpriteLayoutProcessor()
+{
+	if (this->result_seq.capacity() == 0 || _spare_layout_buffers.size() >= MAX_SPARE_LAYOUT_BUFFERS) return;
+
+	this->result_seq.clear();
+	_spare_layout_buffers.push_back(std::move(this->result_seq));
+}
+
 /**
  * Evaluates the register modifiers and integrates them into the preprocessed sprite layout.
+ * Only the sprites found by NewGRFSpriteLayout::Compile are visited; the others are not changed by any chain or register.
  * @param object ResolverObject owning the temporary storage.
  * @param resolved_var10  The value of var10 the action-1-2-3 chain was evaluated for.
  * @param resolved_sprite Result sprite of the action-1-2-3 chain.
@@ -659,25 +717,24 @@ SpriteLayoutProcessor::SpriteLayoutProcessor(const NewGRFSpriteLayout &raw_layou
 void SpriteLayoutProcessor::ProcessRegisters(const ResolverObject &object, uint8_t resolved_var10, uint32_t resolved_sprite)
 {
 	assert(this->raw_layout != nullptr);
-	const TileLayoutRegisters *regs = this->raw_layout->registers.empty() ? nullptr : this->raw_layout->registers.data();
-	bool ground = true;
-	for (DrawTileSeqStruct &result : this->result_seq) {
-		TileLayoutFlags flags = TLF_NOTHING;
-		if (regs != nullptr) flags = regs->flags;
+	for (uint16_t index : this->raw_layout->dynamic_sprites) {
+		DrawTileSeqStruct &result = this->result_seq[index];
+		const TileLayoutRegisters &regs = this->raw_layout->registers[index];
+		TileLayoutFlags flags = regs.flags;
+		bool ground = index == 0;
 
 		/* Is the sprite or bounding box affected by an action-1-2-3 chain? */
 		if (HasBit(result.image.sprite, SPRITE_MODIFIER_CUSTOM_SPRITE) || (flags & TLF_SPRITE_REG_FLAGS)) {
 			/* Does the var10 value apply to this sprite? */
-			uint8_t var10 = (flags & TLF_SPRITE_VAR10) ? regs->sprite_var10 : (ground && this->separate_ground ? 1 : 0);
-			if (var10 == resolved_var10) {
+			if (GetLayoutVar10(flags & TLF_SPRITE_VAR10, regs.sprite_var10, ground, this->separate_ground) == resolved_var10) {
 				/* Apply registers */
-				if ((flags & TLF_DODRAW) && object.GetRegister(regs->dodraw) == 0) {
+				if ((flags & TLF_DODRAW) && object.GetRegister(regs.dodraw) == 0) {
 					result.image.sprite = 0;
 				} else {
 					if (HasBit(result.image.sprite, SPRITE_MODIFIER_CUSTOM_SPRITE)) result.image.sprite += resolved_sprite;
 					if (flags & TLF_SPRITE) {
-						int16_t offset = static_cast<int16_t>(object.GetRegister(regs->sprite)); // mask to 16 bits to avoid trouble
-						if (!HasBit(result.image.sprite, SPRITE_MODIFIER_CUSTOM_SPRITE) || (offset >= 0 && offset < regs->max_sprite_offset)) {
+						int16_t offset = static_cast<int16_t>(object.GetRegister(regs.sprite)); // mask to 16 bits to avoid trouble
+						if (!HasBit(result.image.sprite, SPRITE_MODIFIER_CUSTOM_SPRITE) || (offset >= 0 && offset < regs.max_sprite_offset)) {
 							result.image.sprite += offset;
 						} else {
 							result.image.sprite = SPR_IMG_QUERY;
@@ -686,13 +743,13 @@ void SpriteLayoutProcessor::ProcessRegisters(const ResolverObject &object, uint8
 
 					if (result.IsParentSprite()) {
 						if (flags & TLF_BB_XY_OFFSET) {
-							result.origin.x += object.GetRegister(regs->delta.parent[0]);
-							result.origin.y += object.GetRegister(regs->delta.parent[1]);
+							result.origin.x += object.GetRegister(regs.delta.parent[0]);
+							result.origin.y += object.GetRegister(regs.delta.parent[1]);
 						}
-						if (flags & TLF_BB_Z_OFFSET) result.origin.z += object.GetRegister(regs->delta.parent[2]);
+						if (flags & TLF_BB_Z_OFFSET) result.origin.z += object.GetRegister(regs.delta.parent[2]);
 					} else {
-						if (flags & TLF_CHILD_X_OFFSET) result.origin.x += object.GetRegister(regs->delta.child[0]);
-						if (flags & TLF_CHILD_Y_OFFSET) result.origin.y += object.GetRegister(regs->delta.child[1]);
+						if (flags & TLF_CHILD_X_OFFSET) result.origin.x += object.GetRegister(regs.delta.child[0]);
+						if (flags & TLF_CHILD_Y_OFFSET) result.origin.y += object.GetRegister(regs.delta.child[1]);
 					}
 				}
 			}
@@ -701,13 +758,12 @@ void SpriteLayoutProcessor::ProcessRegisters(const ResolverObject &object, uint8
 		/* Is the palette affected by an action-1-2-3 chain? */
 		if (result.image.sprite != 0 && (HasBit(result.image.pal, SPRITE_MODIFIER_CUSTOM_SPRITE) || (flags & TLF_PALETTE_REG_FLAGS))) {
 			/* Does the var10 value apply to this sprite? */
-			uint8_t var10 = (flags & TLF_PALETTE_VAR10) ? regs->palette_var10 : (ground && this->separate_ground ? 1 : 0);
-			if (var10 == resolved_var10) {
+			if (GetLayoutVar10(flags & TLF_PALETTE_VAR10, regs.palette_var10, ground, this->separate_ground) == resolved_var10) {
 				/* Apply registers */
 				if (HasBit(result.image.pal, SPRITE_MODIFIER_CUSTOM_SPRITE)) result.image.pal += resolved_sprite;
 				if (flags & TLF_PALETTE) {
-					int16_t offset = static_cast<int16_t>(object.GetRegister(regs->palette)); // mask to 16 bits to avoid trouble
-					if (!HasBit(result.image.pal, SPRITE_MODIFIER_CUSTOM_SPRITE) || (offset >= 0 && offset < regs->max_palette_offset)) {
+					int16_t offset = static_cast<int16_t>(object.GetRegister(regs.palette)); // mask to 16 bits to avoid trouble
+					if (!HasBit(result.image.pal, SPRITE_MODIFIER_CUSTOM_SPRITE) || (offset >= 0 && offset < regs.max_palette_offset)) {
 						result.image.pal += offset;
 					} else {
 						result.image.sprite = SPR_IMG_QUERY;
@@ -716,9 +772,6 @@ void SpriteLayoutProcessor::ProcessRegisters(const ResolverObject &object, uint8
 				}
 			}
 		}
-
-		ground = false;
-		if (regs != nullptr) regs++;
 	}
 }
 
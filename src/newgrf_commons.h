@@ -118,8 +118,16 @@ struct NewGRFSpriteLayout : DrawTileSprites {
 	 */
 	uint consistent_max_offset = 0;
 
+	/**
+	 * Indices of the sprites that are changed by an action-1-2-3 chain or by registers; index 0 is the ground sprite.
+	 * Filled by #Compile, so #SpriteLayoutProcessor only visits these sprites when drawing.
+	 */
+	std::vector<uint16_t> dynamic_sprites{};
+	std::array<uint32_t, 2> var10_values{}; ///< Values of variable 10 to resolve sprites for, without and with separate ground sprite chain.
+
 	void Allocate(uint num_sprites);
 	void AllocateRegisters();
+	void Compile();
 
 	/**
 	 * Tests whether this spritelayout needs preprocessing by SpriteLayoutProcessor,
@@ -152,6 +160,10 @@ public:
 	SpriteLayoutProcessor(const NewGRFSpriteLayout &raw_layout) : raw_layout(&raw_layout) {}
 
 	SpriteLayoutProcessor(const NewGRFSpriteLayout &raw_layout, uint32_t orig_offset, uint32_t newgrf_ground_offset, uint32_t newgrf_offset, uint constr_stage, bool separate_ground);
+	~SpriteLayoutProcessor();
+
+	SpriteLayoutProcessor(SpriteLayoutProcessor &&) = default;
+	SpriteLayoutProcessor &operator=(SpriteLayoutProcessor &&) = default;
 
 	/**
 	 * Get values for variable 10 to resolve sprites for.
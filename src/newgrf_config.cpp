@@ -11,6 +11,7 @@
 #include "debug.h"
 #include "3rdparty/md5/md5.h"
 #include "newgrf.h"
+#include "newgrf_scan_cache.h"
 #include "network/network_func.h"
 #include "gfx_func.h"
 #include "newgrf_text.h"
@@ -21,6 +22,7 @@
 #include "strings_func.h"
 #include "textfile_gui.h"
 #include "thread.h"
+#include "worker_pool.h"
 #include "newgrf_config.h"
 #include "newgrf_text.h"
 
@@ -285,13 +287,13 @@ static bool CalcGRFMD5Sum(GRFConfig &config, Subdirectory subdir)
 
 
 /**
- * Find the GRFID of a given grf, and calculate its md5sum.
+ * Find the GRFID of a given grf, without calculating its md5sum.
  * @param config    grf to fill.
  * @param is_static grf is static.
  * @param subdir    the subdirectory to search in.
  * @return Operation was successfully completed.
  */
-bool FillGRFDetails(GRFConfig &config, bool is_static, Subdirectory subdir)
+static bool ReadGRFDetails(GRFConfig &config, bool is_static, Subdirectory subdir)
 {
 	if (!FioCheckFileExists(config.filename, subdir)) {
 		config.status = GRFStatus::NotFound;
@@ -314,7 +316,19 @@ bool FillGRFDetails(GRFConfig &config, bool is_static, Subdirectory subdir)
 		if (config.flags.Test(GRFConfigFlag::Unsafe)) return false;
 	}
 
-	return CalcGRFMD5Sum(config, subdir);
+	return true;
+}
+
+/**
+ * Find the GRFID of a given grf, and calculate its md5sum.
+ * @param config    grf to fill.
+ * @param is_static grf is static.
+ * @param subdir    the subdirectory to search in.
+ * @return Operation was successfully completed.
+ */
+bool FillGRFDetails(GRFConfig &config, bool is_static, Subdirectory subdir)
+{
+	return ReadGRFDetails(config, is_static, subdir) && CalcGRFMD5Sum(config, subdir);
 }
 
 
@@ -485,10 +499,26 @@ compatible_grf:
 /** Set this flag to prevent any NewGRF scanning from being done. */
 int _skip_all_newgrf_scanning = 0;
 
+/** Number of read NewGRFs of which the MD5 sums are calculated together. */
+static const size_t GRF_SCAN_HASH_BATCH_SIZE = 64;
+
+/** A file found while scanning for NewGRFs. */
+struct GRFScanResult {
+	std::unique_ptr<GRFConfig> config; ///< The NewGRF, or \c nullptr if the file is not a usable NewGRF.
+	std::string path; ///< Full path of the file.
+	std::optional<GRFScanStamp> stamp; ///< Size and modification time of the file, if they are known.
+	bool needs_hash = false; ///< Whether the MD5 sum of the NewGRF still needs to be calculated.
+};
+
 /** Helper for scanning for files with GRF as extension */
 class GRFFileScanner : FileScanner {
 	std::chrono::steady_clock::time_point next_update; ///< The next moment we do update the screen.
 	uint num_scanned; ///< The number of GRFs we have scanned.
+	std::vector<GRFScanResult> results; ///< The scanned files, in the order they were found.
+	size_t num_hashed = 0; ///< Number of #results that have been through #HashPending.
+
+	void HashPending();
+	uint AddScannedGRFs();
 
 public:
 	GRFFileScanner() : num_scanned(0)
@@ -510,35 +540,92 @@ public:
 		}
 
 		GRFFileScanner fs;
-		int ret = fs.Scan(".grf", Subdirectory::NewGrf);
+		fs.Scan(".grf", Subdirectory::NewGrf);
+		fs.HashPending();
+		SaveGRFScanCache();
+
 		/* The number scanned and the number returned may not be the same;
 		 * duplicate NewGRFs and base sets are ignored in the return value. */
 		_settings_client.gui.last_newgrf_count = fs.num_scanned;
-		return ret;
+		return fs.AddScannedGRFs();
 	}
 };
 
-bool GRFFileScanner::AddFile(const std::string &filename, size_t basepath_length, const std::string &)
+bool GRFFileScanner::AddFile(const std::string &filename, size_t basepath_length, const std::string &tar_filename)
 {
 	/* Abort if the user stopped the game during a scan. */
 	if (_exit_game) return false;
 
-	bool added = false;
-	auto c = std::make_unique<GRFConfig>(filename.substr(basepath_length));
-	GRFConfig *grfconfig = c.get();
-	if (FillGRFDetails(*c, false)) {
-		if (std::ranges::none_of(_all_grfs, [&c](const auto &gc) { return c->ident.grfid == gc->ident.grfid && c->ident.md5sum == gc->ident.md5sum; })) {
-			_all_grfs.push_back(std::move(c));
-			added = true;
+	GRFScanResult &result = this->results.emplace_back();
+	result.path = filename;
+	/* A file in a tar is only known to be unchanged when the tar is unchanged. */
+	result.stamp = GetGRFScanStamp(tar_filename.empty() ? filename : tar_filename);
+	result.config = std::make_unique<GRFConfig>(filename.substr(basepath_length));
+
+	std::optional<bool> cached = result.stamp.has_value() ? ReadGRFFromScanCache(result.path, *result.stamp, *result.config) : std::nullopt;
+	std::string name;
+	if (cached.has_value()) {
+		name = result.config->GetName();
+		if (*cached) {
+			result.config->SetSuitablePalette();
+		} else {
+			result.config.reset();
+		}
+	} else {
+		result.config = std::make_unique<GRFConfig>(filename.substr(basepath_length));
+		result.needs_hash = ReadGRFDetails(*result.config, false, Subdirectory::NewGrf);
+		name = result.config->GetName();
+		if (!result.needs_hash) {
+			if (result.stamp.has_value()) AddGRFToScanCache(result.path, *result.stamp, nullptr);
+			result.config.reset();
 		}
 	}
 
 	this->num_scanned++;
 
-	std::string name = grfconfig->GetName();
 	UpdateNewGRFScanStatus(this->num_scanned, std::move(name));
 	VideoDriver::GetInstance()->GameLoopPause();
 
+	if (this->results.size() - this->num_hashed >= GRF_SCAN_HASH_BATCH_SIZE) this->HashPending();
+
+	return true;
+}
+
+/** Calculate the MD5 sums of the read NewGRFs that do not have them yet, and remember the scan results. */
+void GRFFileScanner::HashPending()
+{
+	std::span<GRFScanResult> pending(this->results.begin() + this->num_hashed, this->results.end());
+	this->num_hashed = this->results.size();
+
+	/* Hashing reads the whole file, which is the bulk of the scan; spread it over the workers. */
+	RunOnWorkers(pending.size(), [&pending](size_t index) {
+		GRFScanResult &result = pending[index];
+		if (result.needs_hash && !CalcGRFMD5Sum(*result.config, Subdirectory::NewGrf)) result.config.reset();
+	});
+
+	for (GRFScanResult &result : pending) {
+		if (!result.needs_hash) continue;
+		result.needs_hash = false;
+		if (result.stamp.has_value() && result.config != nullptr) AddGRFToScanCache(result.path, *result.stamp, result.config.get());
+	}
+}
+
+/**
+ * Add the scanned NewGRFs to #_all_grfs, skipping duplicates.
+ * @return The number of added NewGRFs.
+ */
+uint GRFFileScanner::AddScannedGRFs()
+{
+	uint added = 0;
+	for (GRFScanResult &result : this->results) {
+		if (result.config == nullptr) continue;
+
+		const GRFConfig &c = *result.config;
+		if (std::ranges::any_of(_all_grfs, [&c](const auto &gc) { return c.ident.grfid == gc->ident.grfid && c.ident.md5sum == gc->ident.md5sum; })) continue;
+
+		_all_grfs.push_back(std::move(result.config));
+		added++;
+	}
 	return added;
 }
 
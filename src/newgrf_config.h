@@ -213,6 +213,7 @@ extern GRFConfigList _grfconfig;         ///< First item in list of current GRF
 extern GRFConfigList _grfconfig_newgame; ///< First item in list of default GRF set up
 extern GRFConfigList _grfconfig_static;  ///< First item in list of static GRF set up
 extern uint _missing_extra_graphics;  ///< Number of sprites provided by the fallback extra GRF, i.e. missing in the baseset.
+extern bool _newgrf_scan_cache;        ///< Whether the results of scanning NewGRFs are cached on disk.
 
 /** Callback for NewGRF scanning. */
 struct NewGRFScanCallback {
@@ -20,6 +20,8 @@
 #include "vehicle_gui.h"
 #include "zoom_func.h"
 #include "core/string_consumer.hpp"
+#include "timer/timer.h"
+#include "timer/timer_window.h"
 
 #include "engine_base.h"
 #include "industry.h"
@@ -36,6 +38,7 @@
 #include "newgrf_badge.h"
 #include "newgrf_debug.h"
 #include "newgrf_object.h"
+#include "newgrf_profiling.h"
 #include "newgrf_spritegroup.h"
 #include "newgrf_station.h"
 #include "newgrf_town.h"
@@ -271,6 +274,13 @@ struct NewGRFInspectWindow : Window {
 
 	Scrollbar *vscroll = nullptr;
 
+	static constexpr size_t PROFILE_TOP_COUNT = 5; ///< Number of sprite groups shown of a running aggregate profile.
+
+	/** Keep the shown profile up to date while it is being collected. */
+	const IntervalTimer<TimerWindow> profile_interval = {std::chrono::seconds(1), [this](auto) {
+		if (std::ranges::any_of(_newgrf_profilers, [](const NewGRFProfiler &pr) { return pr.active && pr.mode == NewGRFProfiler::Mode::Aggregate; })) this->SetDirty();
+	}};
+
 	/**
 	 * Check whether the given variable has a parameter.
 	 * @param variable the variable to check.
@@ -535,6 +545,15 @@ struct NewGRFInspectWindow : Window {
 			}
 		}
 
+		GrfID grfid = nih.GetGRFID(index);
+		auto profiler = std::ranges::find_if(_newgrf_profilers, [grfid](const NewGRFProfiler &pr) { return pr.active && pr.mode == NewGRFProfiler::Mode::Aggregate && pr.grffile->grfid == grfid; });
+		if (profiler != std::end(_newgrf_profilers)) {
+			this->DrawString(r, i++, fmt::format("Profile [{}], slowest sprite groups:", FormatArrayAsHex(grfid)));
+			for (const NewGRFProfiler::Aggregate *a : profiler->GetTopAggregates(NewGRFInspectWindow::PROFILE_TOP_COUNT)) {
+				this->DrawString(r, i++, fmt::format("  sprite {}, feature {:02x}, callback {:03x}: {} calls, {} us", a->root_sprite, a->feat, (uint)a->cb, a->calls, a->GetEstimatedNanoseconds() / 1000));
+			}
+		}
+
 		/* Not nice and certainly a hack, but it beats duplicating
 		 * this whole function just to count the actual number of
 		 * elements. Especially because they need to be redrawn. */
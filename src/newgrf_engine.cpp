@@ -17,6 +17,7 @@
 #include "newgrf_cargo.h"
 #include "newgrf_spritegroup.h"
 #include "timer/timer_game_calendar.h"
+#include "timer/timer_game_tick.h"
 #include "vehicle_func.h"
 #include "core/random_func.hpp"
 #include "core/container_func.hpp"
@@ -309,13 +310,18 @@ static uint8_t MapAircraftMovementAction(const Aircraft *v)
 }
 
 
+bool _memoise_vehicle_callbacks = false; ///< Whether #GetVehicleCallback remembers its results for the rest of the tick.
+
 /* virtual */ uint32_t VehicleScopeResolver::GetRandomBits() const
 {
+	/* The random bits of the vehicle itself only change when rerandomising, which clears the remembered results. */
+	if (!this->memoisable_scope) this->tick_stable = false;
 	return this->v == nullptr ? 0 : this->v->random_bits;
 }
 
 /* virtual */ uint32_t VehicleScopeResolver::GetRandomTriggers() const
 {
+	if (!this->memoisable_scope) this->tick_stable = false;
 	return this->v == nullptr ? 0 : this->v->waiting_random_triggers.base();
 }
 
@@ -978,8 +984,44 @@ static uint32_t VehicleGetVariable(Vehicle *v, const VehicleScopeResolver *objec
 	return UINT_MAX;
 }
 
+/**
+ * Check whether a vehicle variable stays the same for the rest of the tick.
+ * These are the variables that are cached in #NewGRFCache, and the variables that only change
+ * with the engine, the cargo type or the cargo subtype; they all come with invalidating the NewGRF cache.
+ * @param variable The variable.
+ * @return True iff the variable does not change within a tick.
+ */
+static bool IsTickStableVehicleVariable(uint8_t variable)
+{
+	switch (variable) {
+		case 0x25: // Engine GRF ID
+		case 0x40: // Position in consist
+		case 0x41: // Position in same consecutive wagons
+		case 0x42: // Consist cargo information
+		case 0x43: // Company information
+		case 0x47: // Vehicle cargo info
+		case 0x49: // Build year
+		case 0x4D: // Position in articulated vehicle
+		case 0x7A: // Engine badges
+		case 0x80: // Vehicle type
+		case 0x84: // Vehicle index
+		case 0x85:
+		case 0xB9: // Cargo type
+		case 0xC4: // Build year
+		case 0xC6: // Engine ID
+		case 0xC7:
+		case 0xF2: // Cargo subtype
+			return true;
+
+		default:
+			return false;
+	}
+}
+
 /* virtual */ uint32_t VehicleScopeResolver::GetVariable(uint8_t variable, [[maybe_unused]] uint32_t parameter, bool &available) const
 {
+	if (!this->memoisable_scope || !IsTickStableVehicleVariable(variable)) this->tick_stable = false;
+
 	if (this->v == nullptr) {
 		/* Vehicle does not exist, so we're in a purchase list */
 		switch (variable) {
@@ -1022,6 +1064,9 @@ static uint32_t VehicleGetVariable(Vehicle *v, const VehicleScopeResolver *objec
 {
 	const Vehicle *v = this->self_scope.v;
 
+	/* The sprite set depends on the load of the vehicle. */
+	this->self_scope.tick_stable = false;
+
 	if (v == nullptr) {
 		if (!group.loading.empty()) return group.loading[0];
 		if (!group.loaded.empty()) return group.loaded[0];
@@ -1087,6 +1132,10 @@ VehicleResolverObject::VehicleResolverObject(EngineID engine_type, const Vehicle
 	relative_scope(*this, engine_type, v, rotor_in_gui),
 	cached_relative_count(0)
 {
+	this->self_scope.memoisable_scope = true;
+	this->fixed_scopes[VarSpriteGroupScope::Self] = &this->self_scope;
+	this->fixed_scopes[VarSpriteGroupScope::Parent] = &this->parent_scope;
+
 	if (wagon_override == WagonOverride::Self) {
 		this->root_spritegroup = GetWagonOverrideSpriteSet(engine_type, CargoGRFFileProps::SG_DEFAULT, engine_type);
 	} else {
@@ -1206,8 +1255,31 @@ bool UsesWagonOverride(const Vehicle *v)
  */
 uint16_t GetVehicleCallback(CallbackID callback, uint32_t param1, uint32_t param2, EngineID engine, const Vehicle *v, std::span<int32_t> regs100)
 {
+	/* While the vehicles are ticked, the same callbacks get resolved over and over again for the same vehicle.
+	 * Results that only depend on variables that do not change within the tick are remembered. Results with
+	 * registers are not, and neither are the results of vehicles that do not exist yet. */
+	VehicleCallbackMemo *memo = nullptr;
+	bool memo_valid = false;
+	if (_memoise_vehicle_callbacks && v != nullptr && regs100.empty()) {
+		memo = &v->callback_memo[(callback ^ param1 ^ (param2 << 2)) % v->callback_memo.size()];
+		memo_valid = memo->tick == TimerGameTick::counter && memo->engine == engine && memo->callback == callback &&
+				memo->param1 == param1 && memo->param2 == param2 && memo->cargo_type == v->cargo_type && memo->cargo_subtype == v->cargo_subtype;
+
+		/* With debug level grf=5 or higher, remembered results are checked against resolving them again. */
+		if (memo_valid && _debug_grf_level < 5) return memo->result;
+	}
+
 	VehicleResolverObject object(engine, v, VehicleResolverObject::WagonOverride::Uncached, false, callback, param1, param2);
-	return object.ResolveCallback(regs100);
+	uint16_t result = object.ResolveCallback(regs100);
+
+	if (memo_valid) {
+		if (memo->result != result) {
+			Debug(grf, 0, "Remembered result {} of callback 0x{:X} for vehicle {} differs from {}", memo->result, to_underlying(callback), v->index, result);
+		}
+	} else if (memo != nullptr && object.IsTickStable()) {
+		*memo = {TimerGameTick::counter, engine, callback, param1, param2, v->cargo_type, v->cargo_subtype, result};
+	}
+	return result;
 }
 
 /**
@@ -1286,6 +1358,9 @@ static void DoTriggerVehicleRandomisation(Vehicle *v, VehicleRandomTrigger trigg
 	v->random_bits &= ~reseed;
 	v->random_bits |= (first ? new_random_bits : base_random_bits) & reseed;
 
+	/* The remembered callback results may depend on the random bits and triggers. */
+	v->callback_memo = {};
+
 	switch (trigger) {
 		case VehicleRandomTrigger::NewCargo:
 			/* All vehicles in chain get ANY_NEW_CARGO trigger now.
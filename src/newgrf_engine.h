@@ -36,6 +36,9 @@ struct VehicleScopeResolver : public ScopeResolver {
 	{
 	}
 
+	bool memoisable_scope = false; ///< Whether the results of this scope may be remembered for the tick; only for the vehicle itself.
+	mutable bool tick_stable = true; ///< Whether everything read from this scope stays the same for the rest of the tick.
+
 	void SetVehicle(const Vehicle *v) { this->v = v; }
 
 	uint32_t GetRandomBits() const override;
@@ -68,8 +71,19 @@ struct VehicleResolverObject : public SpecializedResolverObject<VehicleRandomTri
 
 	GrfSpecFeature GetFeature() const override;
 	uint32_t GetDebugID() const override;
+
+	/**
+	 * Check whether the result of the resolve stays the same for the rest of the tick.
+	 * @return True iff only variables of the vehicle itself were read, that do not change within a tick.
+	 */
+	bool IsTickStable() const
+	{
+		return this->self_scope.tick_stable && this->parent_scope.tick_stable && this->relative_scope.tick_stable;
+	}
 };
 
+extern bool _memoise_vehicle_callbacks;
+
 static const uint TRAININFO_DEFAULT_VEHICLE_WIDTH   = 29;
 static const uint ROADVEHINFO_DEFAULT_VEHICLE_WIDTH = 32;
 static const uint VEHICLEINFO_FULL_VEHICLE_WIDTH    = 32;
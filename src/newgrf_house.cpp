@@ -115,6 +115,9 @@ HouseResolverObject::HouseResolverObject(HouseID house_id, TileIndex tile, Town
 	/* Tile must be valid and a house tile, unless not yet constructed in which case it may also be INVALID_TILE. */
 	assert((IsValidTile(tile) && (not_yet_constructed || IsTileType(tile, TileType::House))) || (not_yet_constructed && tile == INVALID_TILE));
 
+	this->fixed_scopes[VarSpriteGroupScope::Self] = &this->house_scope;
+	this->fixed_scopes[VarSpriteGroupScope::Parent] = &this->town_scope;
+
 	this->root_spritegroup = HouseSpec::Get(house_id)->grf_prop.GetSpriteGroup(!not_yet_constructed);
 }
 
@@ -587,12 +590,12 @@ struct HouseAnimationBase : public AnimationBase<HouseAnimationBase, HouseSpec,
 	static constexpr HouseCallbackMask cbm_animation_next_frame = HouseCallbackMask::AnimationNextFrame;
 };
 
-void AnimateNewHouseTile(TileIndex tile)
+uint AnimateNewHouseTile(TileIndex tile)
 {
 	const HouseSpec *hs = HouseSpec::Get(GetHouseType(tile));
-	if (hs == nullptr) return;
+	if (hs == nullptr) return 1;
 
-	HouseAnimationBase::AnimateTile(hs, Town::GetByTile(tile), tile, hs->extra_flags.Test(HouseExtraFlag::Callback1ARandomBits));
+	return HouseAnimationBase::AnimateTile(hs, Town::GetByTile(tile), tile, hs->extra_flags.Test(HouseExtraFlag::Callback1ARandomBits));
 }
 
 void TriggerHouseAnimation_ConstructionStageChanged(TileIndex tile, bool first_call)
@@ -146,6 +146,8 @@ IndustryTileResolverObject::IndustryTileResolverObject(IndustryGfx gfx, TileInde
 	ind_scope(*this, tile, indus, indus->type),
 	gfx(gfx)
 {
+	this->fixed_scopes[VarSpriteGroupScope::Self] = &this->indtile_scope;
+	this->fixed_scopes[VarSpriteGroupScope::Parent] = &this->ind_scope;
 	this->root_spritegroup = GetIndustryTileSpec(gfx)->grf_prop.GetSpriteGroup(indus->index != IndustryID::Invalid());
 }
 
@@ -268,12 +270,12 @@ struct IndustryAnimationBase : public AnimationBase<IndustryAnimationBase, Indus
 	static constexpr IndustryTileCallbackMask cbm_animation_next_frame = IndustryTileCallbackMask::AnimationNextFrame;
 };
 
-void AnimateNewIndustryTile(TileIndex tile)
+uint AnimateNewIndustryTile(TileIndex tile)
 {
 	const IndustryTileSpec *itspec = GetIndustryTileSpec(GetIndustryGfx(tile));
-	if (itspec == nullptr) return;
+	if (itspec == nullptr) return 1;
 
-	IndustryAnimationBase::AnimateTile(itspec, Industry::GetByTile(tile), tile, itspec->special_flags.Test(IndustryTileSpecialFlag::NextFrameRandomBits));
+	return IndustryAnimationBase::AnimateTile(itspec, Industry::GetByTile(tile), tile, itspec->special_flags.Test(IndustryTileSpecialFlag::NextFrameRandomBits));
 }
 
 static bool DoTriggerIndustryTileAnimation(TileIndex tile, IndustryAnimationTrigger iat, uint32_t random, uint32_t var18_extra = 0)
@@ -390,6 +390,7 @@ ObjectResolverObject::ObjectResolverObject(const ObjectSpec *spec, Object *obj,
 		CallbackID callback, uint32_t param1, uint32_t param2)
 	: ResolverObject(spec->grf_prop.grffile, callback, param1, param2), object_scope(*this, obj, spec, tile, view)
 {
+	this->fixed_scopes[VarSpriteGroupScope::Self] = &this->object_scope;
 	this->root_spritegroup = spec->grf_prop.GetSpriteGroup(obj != nullptr);
 }
 
@@ -552,13 +553,14 @@ struct ObjectAnimationBase : public AnimationBase<ObjectAnimationBase, ObjectSpe
 /**
  * Handle the animation of the object tile.
  * @param tile The tile to animate.
+ * @return The number of ticks until the tile needs animating again.
  */
-void AnimateNewObjectTile(TileIndex tile)
+uint AnimateNewObjectTile(TileIndex tile)
 {
 	const ObjectSpec *spec = ObjectSpec::GetByTile(tile);
-	if (spec == nullptr || !spec->flags.Test(ObjectFlag::Animation)) return;
+	if (spec == nullptr || !spec->flags.Test(ObjectFlag::Animation)) return 1;
 
-	ObjectAnimationBase::AnimateTile(spec, Object::GetByTile(tile), tile, spec->flags.Test(ObjectFlag::AnimRandomBits));
+	return ObjectAnimationBase::AnimateTile(spec, Object::GetByTile(tile), tile, spec->flags.Test(ObjectFlag::AnimRandomBits));
 }
 
 static bool DoTriggerObjectTileAnimation(Object *o, TileIndex tile, ObjectAnimationTrigger trigger, const ObjectSpec *spec, uint32_t random, uint32_t var18_extra = 0)
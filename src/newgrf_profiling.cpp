@@ -17,13 +17,15 @@
 #include "3rdparty/fmt/chrono.h"
 #include "timer/timer.h"
 #include "timer/timer_game_tick.h"
-
-#include <chrono>
+#include "core/bitmath_func.hpp"
 
 #include "safeguards.h"
 
 std::vector<NewGRFProfiler> _newgrf_profilers;
 
+/* static */ NewGRFProfiler::Mode NewGRFProfiler::start_mode = NewGRFProfiler::Mode::Trace;
+/* static */ uint NewGRFProfiler::start_sample_interval = 1;
+
 
 /**
  * Create profiler object and begin profiling session.
@@ -49,10 +51,19 @@ void NewGRFProfiler::BeginResolve(const ResolverObject &resolver)
 	using namespace std::chrono;
 	this->cur_call.root_sprite = resolver.root_spritegroup->nfo_line;
 	this->cur_call.subs = 0;
-	this->cur_call.time = (uint32_t)time_point_cast<microseconds>(high_resolution_clock::now()).time_since_epoch().count();
-	this->cur_call.tick = TimerGameTick::counter;
 	this->cur_call.cb = resolver.callback;
 	this->cur_call.feat = resolver.GetFeature();
+
+	if (this->mode == Mode::Aggregate) {
+		/* Only the calls that are timed need the clock; that is the expensive part. */
+		this->cur_timed = this->sample_counter == 0;
+		this->sample_counter = this->cur_timed ? this->sample_interval - 1 : this->sample_counter - 1;
+		if (this->cur_timed) this->cur_start = steady_clock::now();
+		return;
+	}
+
+	this->cur_call.time = (uint32_t)time_point_cast<microseconds>(high_resolution_clock::now()).time_since_epoch().count();
+	this->cur_call.tick = TimerGameTick::counter;
 	this->cur_call.item = resolver.GetDebugID();
 }
 
@@ -63,6 +74,11 @@ void NewGRFProfiler::BeginResolve(const ResolverObject &resolver)
 void NewGRFProfiler::EndResolve(const ResolverResult &result)
 {
 	using namespace std::chrono;
+	if (this->mode == Mode::Aggregate) {
+		this->AggregateCall(this->cur_timed ? duration_cast<nanoseconds>(steady_clock::now() - this->cur_start).count() : 0);
+		return;
+	}
+
 	this->cur_call.time = (uint32_t)time_point_cast<microseconds>(high_resolution_clock::now()).time_since_epoch().count() - this->cur_call.time;
 
 	struct visitor {
@@ -92,6 +108,71 @@ void NewGRFProfiler::EndResolve(const ResolverResult &result)
 	this->calls.push_back(this->cur_call);
 }
 
+/**
+ * Add the current call to the aggregate table.
+ * @param nanoseconds Time taken by the call, if it was timed.
+ */
+void NewGRFProfiler::AggregateCall(uint64_t nanoseconds)
+{
+	const Call &c = this->cur_call;
+	size_t slot = (c.root_sprite * 0x9E3779B1U ^ to_underlying(c.cb) << 8 ^ to_underlying(c.feat)) & (AGGREGATE_TABLE_SIZE - 1);
+	for (size_t probe = 0; probe < AGGREGATE_TABLE_SIZE; probe++, slot = (slot + 1) & (AGGREGATE_TABLE_SIZE - 1)) {
+		Aggregate &a = this->aggregates[slot];
+		if (a.calls == 0) {
+			a.root_sprite = c.root_sprite;
+			a.cb = c.cb;
+			a.feat = c.feat;
+		} else if (a.root_sprite != c.root_sprite || a.cb != c.cb || a.feat != c.feat) {
+			continue;
+		}
+
+		a.calls++;
+		a.subs += c.subs;
+		if (this->cur_timed) {
+			a.timed++;
+			a.nanoseconds += nanoseconds;
+			a.max_nanoseconds = std::max(a.max_nanoseconds, nanoseconds);
+			uint bucket = nanoseconds < 256 ? 0 : FindLastBit(nanoseconds) - 7;
+			a.histogram[std::min<uint>(bucket, Aggregate::HISTOGRAM_SIZE - 1)]++;
+		}
+		return;
+	}
+
+	/* The table is full; the call is only counted. */
+	this->overflow_calls++;
+}
+
+/**
+ * Get the aggregated calls that took the most time.
+ * @param count The maximum number of entries to return.
+ * @return The entries, slowest first.
+ */
+std::vector<const NewGRFProfiler::Aggregate *> NewGRFProfiler::GetTopAggregates(size_t count) const
+{
+	std::vector<const Aggregate *> result;
+	for (const Aggregate &a : this->aggregates) {
+		if (a.calls != 0) result.push_back(&a);
+	}
+
+	count = std::min(count, result.size());
+	std::partial_sort(result.begin(), result.begin() + count, result.end(), [](const Aggregate *a, const Aggregate *b) {
+		return a->GetEstimatedNanoseconds() > b->GetEstimatedNanoseconds();
+	});
+	result.resize(count);
+	return result;
+}
+
+/**
+ * Get the estimated time taken by all aggregated calls.
+ * @return The time in nanoseconds.
+ */
+uint64_t NewGRFProfiler::GetEstimatedNanoseconds() const
+{
+	uint64_t total = 0;
+	for (const Aggregate &a : this->aggregates) total += a.GetEstimatedNanoseconds();
+	return total;
+}
+
 /**
  * Capture a recursive sprite group resolution.
  */
@@ -104,13 +185,26 @@ void NewGRFProfiler::Start()
 {
 	this->Abort();
 	this->active = true;
+	this->mode = NewGRFProfiler::start_mode;
+	this->sample_interval = std::max(1U, NewGRFProfiler::start_sample_interval);
+	this->sample_counter = 0;
 	this->start_tick = TimerGameTick::counter;
+	if (this->mode == Mode::Aggregate) this->aggregates.resize(AGGREGATE_TABLE_SIZE);
 }
 
 uint32_t NewGRFProfiler::Finish()
 {
 	if (!this->active) return 0;
 
+	return this->mode == Mode::Aggregate ? this->FinishAggregate() : this->FinishTrace();
+}
+
+/**
+ * Finish a profile in trace mode, writing all calls.
+ * @return Total time taken by the calls, in microseconds.
+ */
+uint32_t NewGRFProfiler::FinishTrace()
+{
 	if (this->calls.empty()) {
 		IConsolePrint(CC_DEBUG, "Finished profile of NewGRF [{}], no events collected, not writing a file.", FormatArrayAsHex(this->grffile->grfid));
 
@@ -139,10 +233,51 @@ uint32_t NewGRFProfiler::Finish()
 	return total_microseconds;
 }
 
+/**
+ * Finish a profile in aggregate mode, writing the aggregated calls.
+ * @return Estimated total time taken by the calls, in microseconds.
+ */
+uint32_t NewGRFProfiler::FinishAggregate()
+{
+	std::vector<const Aggregate *> aggregates = this->GetTopAggregates(AGGREGATE_TABLE_SIZE);
+	if (aggregates.empty()) {
+		IConsolePrint(CC_DEBUG, "Finished profile of NewGRF [{}], no events collected, not writing a file.", FormatArrayAsHex(this->grffile->grfid));
+
+		this->Abort();
+		return 0;
+	}
+
+	std::string filename = this->GetOutputFilename();
+	IConsolePrint(CC_DEBUG, "Finished profile of NewGRF [{}], writing {} aggregated events to '{}'.", FormatArrayAsHex(this->grffile->grfid), aggregates.size(), filename);
+	if (this->overflow_calls > 0) IConsolePrint(CC_WARNING, "{} calls did not fit in the aggregate table and are not included.", this->overflow_calls);
+
+	uint32_t total_microseconds = static_cast<uint32_t>(this->GetEstimatedNanoseconds() / 1000);
+
+	auto f = FioFOpenFile(filename, "wt", Subdirectory::None);
+
+	if (!f.has_value()) {
+		IConsolePrint(CC_ERROR, "Failed to open '{}' for writing.", filename);
+	} else {
+		fmt::print(*f, "Sprite,Feature,CallbackID,Calls,TimedCalls,Microseconds,MaxMicroseconds,Depth");
+		for (uint i = 0; i < Aggregate::HISTOGRAM_SIZE; i++) fmt::print(*f, ",Below{}ns", 1U << (8 + i));
+		fmt::print(*f, "\n");
+		for (const Aggregate *a : aggregates) {
+			fmt::print(*f, "{},0x{:X},0x{:X},{},{},{},{},{}", a->root_sprite, a->feat, (uint)a->cb, a->calls, a->timed, a->GetEstimatedNanoseconds() / 1000, a->max_nanoseconds / 1000, a->subs);
+			for (uint32_t bucket : a->histogram) fmt::print(*f, ",{}", bucket);
+			fmt::print(*f, "\n");
+		}
+	}
+
+	this->Abort();
+	return total_microseconds;
+}
+
 void NewGRFProfiler::Abort()
 {
 	this->active = false;
 	this->calls.clear();
+	this->aggregates.clear();
+	this->overflow_calls = 0;
 }
 
 /**
@@ -151,7 +286,8 @@ void NewGRFProfiler::Abort()
  */
 std::string NewGRFProfiler::GetOutputFilename() const
 {
-	return fmt::format("{}grfprofile-{:%Y%m%d-%H%M}-{}.csv", FiosGetScreenshotDir(), fmt::localtime(time(nullptr)), FormatArrayAsHex(this->grffile->grfid));
+	std::string_view suffix = this->mode == Mode::Aggregate ? "-aggregate" : "";
+	return fmt::format("{}grfprofile-{:%Y%m%d-%H%M}-{}{}.csv", FiosGetScreenshotDir(), fmt::localtime(time(nullptr)), FormatArrayAsHex(this->grffile->grfid), suffix);
 }
 
 /* static */ uint32_t NewGRFProfiler::FinishAll()
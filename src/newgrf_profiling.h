@@ -14,12 +14,19 @@
 #include "newgrf.h"
 #include "newgrf_callbacks.h"
 #include "newgrf_spritegroup.h"
+#include <chrono>
 
 
 /**
  * Callback profiler for NewGRF development
  */
 struct NewGRFProfiler {
+	/** How a profiler collects its data. */
+	enum class Mode : uint8_t {
+		Trace, ///< Record every call, and write all of them to a CSV file.
+		Aggregate, ///< Only count and time the calls per root sprite group, callback and feature.
+	};
+
 	NewGRFProfiler(const GRFFile *grffile);
 	~NewGRFProfiler();
 
@@ -48,11 +55,55 @@ struct NewGRFProfiler {
 		GrfSpecFeature feat; ///< GRF feature being resolved for
 	};
 
+	/** Accumulated measurements of the calls with the same root sprite group, callback and feature. */
+	struct Aggregate {
+		static constexpr uint HISTOGRAM_SIZE = 16; ///< Number of buckets of #histogram.
+
+		uint32_t root_sprite = 0; ///< Pseudo-sprite index in GRF file
+		CallbackID cb{}; ///< Callback ID
+		GrfSpecFeature feat{}; ///< GRF feature being resolved for
+		uint64_t calls = 0; ///< Number of calls; 0 for an unused entry
+		uint64_t timed = 0; ///< Number of calls that have been timed
+		uint64_t nanoseconds = 0; ///< Total time taken by the timed calls
+		uint64_t max_nanoseconds = 0; ///< Time taken by the slowest timed call
+		uint64_t subs = 0; ///< Total sub-calls to other sprite groups
+		std::array<uint32_t, HISTOGRAM_SIZE> histogram{}; ///< Number of timed calls that took less than 2^(8+i) nanoseconds; the last bucket also counts all slower calls
+
+		/**
+		 * Get the estimated time taken by all calls, timed or not.
+		 * @return The time in nanoseconds.
+		 */
+		uint64_t GetEstimatedNanoseconds() const
+		{
+			return this->timed == 0 ? 0 : static_cast<uint64_t>(static_cast<double>(this->nanoseconds) * this->calls / this->timed);
+		}
+	};
+
+	static constexpr size_t AGGREGATE_TABLE_SIZE = 1024; ///< Number of entries of the aggregate table; a power of two.
+
+	std::vector<const Aggregate *> GetTopAggregates(size_t count) const;
+	uint64_t GetEstimatedNanoseconds() const;
+
+	static Mode start_mode; ///< Mode the profilers collect their data in when started.
+	static uint start_sample_interval; ///< In aggregate mode, time one in this many calls when started.
+
 	const GRFFile *grffile = nullptr; ///< Which GRF is being profiled
 	bool active = false; ///< Is this profiler collecting data
+	Mode mode = Mode::Trace; ///< How this profiler collects its data
+	uint sample_interval = 1; ///< In aggregate mode, one in this many calls is timed
+	uint sample_counter = 0; ///< Calls till the next call that is timed
 	uint64_t start_tick = 0; ///< Tick number this profiler was started on
 	Call cur_call{}; ///< Data for current call in progress
+	std::chrono::steady_clock::time_point cur_start{}; ///< Start time of the current call, if it is timed in aggregate mode
+	bool cur_timed = false; ///< Whether the current call is timed in aggregate mode
 	std::vector<Call> calls{}; ///< All calls collected so far
+	std::vector<Aggregate> aggregates{}; ///< Open addressed table of the aggregated calls, in aggregate mode
+	uint64_t overflow_calls = 0; ///< Calls that did not fit in the full aggregate table
+
+private:
+	void AggregateCall(uint64_t nanoseconds);
+	uint32_t FinishTrace();
+	uint32_t FinishAggregate();
 };
 
 extern std::vector<NewGRFProfiler> _newgrf_profilers;
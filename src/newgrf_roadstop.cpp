@@ -229,6 +229,8 @@ RoadStopResolverObject::RoadStopResolverObject(const RoadStopSpec *roadstopspec,
 		CallbackID callback, uint32_t param1, uint32_t param2)
 	: SpecializedResolverObject<StationRandomTriggers>(roadstopspec->grf_prop.grffile, callback, param1, param2), roadstop_scope(*this, st, roadstopspec, tile, roadtype, type, view)
 {
+	this->fixed_scopes[VarSpriteGroupScope::Self] = &this->roadstop_scope;
+
 	CargoType ctype = CargoGRFFileProps::SG_DEFAULT_NA;
 
 	if (st == nullptr) {
@@ -386,12 +388,12 @@ struct RoadStopAnimationBase : public AnimationBase<RoadStopAnimationBase, RoadS
 	static constexpr RoadStopCallbackMask cbm_animation_next_frame = RoadStopCallbackMask::AnimationNextFrame;
 };
 
-void AnimateRoadStopTile(TileIndex tile)
+uint AnimateRoadStopTile(TileIndex tile)
 {
 	const RoadStopSpec *ss = GetRoadStopSpec(tile);
-	if (ss == nullptr) return;
+	if (ss == nullptr) return 1;
 
-	RoadStopAnimationBase::AnimateTile(ss, BaseStation::GetByTile(tile), tile, ss->flags.Test(RoadStopSpecFlag::Cb141RandomBits));
+	return RoadStopAnimationBase::AnimateTile(ss, BaseStation::GetByTile(tile), tile, ss->flags.Test(RoadStopSpecFlag::Cb141RandomBits));
 }
 
 void TriggerRoadStopAnimation(BaseStation *st, TileIndex trigger_tile, StationAnimationTrigger trigger, CargoType cargo_type)
@@ -0,0 +1,401 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file newgrf_scan_cache.cpp Cache of the results of scanning NewGRF files, so unchanged files do not need to be read again. */
+
+#include "stdafx.h"
+#include "newgrf_scan_cache.h"
+#include "core/string_builder.hpp"
+#include "core/string_consumer.hpp"
+#include "debug.h"
+#include "fileio_func.h"
+#include "rev.h"
+#include <filesystem>
+
+#include "safeguards.h"
+
+bool _newgrf_scan_cache = true;
+
+static const uint32_t GRF_SCAN_CACHE_MAGIC = 'O' | 'T' << 8 | 'G' << 16 | 'S' << 24; ///< Identification of the cache file.
+static const uint32_t GRF_SCAN_CACHE_VERSION = 1; ///< Version of the format of the cache file.
+static const size_t GRF_SCAN_CACHE_MAX_SIZE = 64 * 1024 * 1024; ///< Size above which the cache file is ignored.
+
+/** Cached scan result of a single file. */
+struct GRFScanCacheEntry {
+	GRFScanStamp stamp; ///< Size and modification time of the file when it was scanned.
+	std::string data; ///< The serialised scan result, or empty when the file is not a usable NewGRF.
+	bool used = false; ///< Whether the file was found during the current scan.
+};
+
+/** The cached scan results of all files. */
+struct GRFScanCache {
+	bool loaded = false; ///< Whether the cache file has been read.
+	bool dirty = false; ///< Whether the cache differs from the cache file.
+	std::unordered_map<std::string, GRFScanCacheEntry> entries; ///< Scan results by full path of the file.
+};
+
+static GRFScanCache _grf_scan_cache;
+
+/** Reader of the cache file that remembers whether it ran out of data, instead of failing each read. */
+struct GRFScanCacheReader {
+	StringConsumer consumer; ///< The data to read.
+	bool error = false; ///< Whether a read went past the end of the data.
+
+	/**
+	 * Create a reader of the given data.
+	 * @param data The data to read.
+	 */
+	GRFScanCacheReader(std::string_view data) : consumer(data) {}
+
+	/**
+	 * Read a value, or mark the data invalid.
+	 * @param value The read value, if any.
+	 * @return The value, or 0 when there was none.
+	 */
+	template <typename T>
+	T Check(std::optional<T> value)
+	{
+		if (!value.has_value()) this->error = true;
+		return value.value_or(0);
+	}
+
+	uint8_t ReadUint8() { return this->Check(this->consumer.TryReadUint8()); }
+	uint32_t ReadUint32() { return this->Check(this->consumer.TryReadUint32LE()); }
+	uint64_t ReadUint64() { return this->Check(this->consumer.TryReadUint64LE()); }
+
+	/**
+	 * Read a string, prefixed with its length.
+	 * @return The string, or empty when the data ran out.
+	 */
+	std::string_view ReadString()
+	{
+		uint32_t length = this->ReadUint32();
+		if (length > this->consumer.GetBytesLeft()) {
+			this->error = true;
+			return {};
+		}
+		return this->consumer.Read(length);
+	}
+
+	/**
+	 * Read a fixed number of bytes.
+	 * @param[out] dest Where to put the bytes.
+	 */
+	void ReadBytes(std::span<uint8_t> dest)
+	{
+		std::string_view data = this->consumer.Read(dest.size());
+		if (data.size() != dest.size()) {
+			this->error = true;
+			return;
+		}
+		std::copy(data.begin(), data.end(), dest.begin());
+	}
+};
+
+/**
+ * Write a string, prefixed with its length.
+ * @param builder The builder to write to.
+ * @param str The string.
+ */
+static void WriteGRFScanString(StringBuilder &builder, std::string_view str)
+{
+	builder.PutUint32LE(static_cast<uint32_t>(str.size()));
+	builder.Put(str);
+}
+
+/**
+ * Write a fixed number of bytes.
+ * @param builder The builder to write to.
+ * @param data The bytes.
+ */
+static void WriteGRFScanBytes(StringBuilder &builder, std::span<const uint8_t> data)
+{
+	builder.Put(std::string_view{reinterpret_cast<const char *>(data.data()), data.size()});
+}
+
+/**
+ * Write the translations of a text.
+ * @param builder The builder to write to.
+ * @param list The translations.
+ */
+static void WriteGRFScanTextList(StringBuilder &builder, const GRFTextList &list)
+{
+	builder.PutUint32LE(static_cast<uint32_t>(list.size()));
+	for (const GRFText &text : list) {
+		builder.PutUint8(to_underlying(text.langid));
+		WriteGRFScanString(builder, text.text);
+	}
+}
+
+/**
+ * Read the translations of a text.
+ * @param reader The reader to read from.
+ * @param[out] list The translations.
+ */
+static void ReadGRFScanTextList(GRFScanCacheReader &reader, GRFTextList &list)
+{
+	uint32_t count = reader.ReadUint32();
+	for (uint32_t i = 0; i < count && !reader.error; i++) {
+		GRFLanguage langid = static_cast<GRFLanguage>(reader.ReadUint8());
+		list.push_back({langid, std::string{reader.ReadString()}});
+	}
+}
+
+/**
+ * Read the translations of a text that might not be set.
+ * @param reader The reader to read from.
+ * @param[out] wrapper The translations; only set when there are any.
+ */
+static void ReadGRFScanTextList(GRFScanCacheReader &reader, GRFTextWrapper &wrapper)
+{
+	GRFTextList list;
+	ReadGRFScanTextList(reader, list);
+	if (!list.empty()) wrapper = std::make_shared<GRFTextList>(std::move(list));
+}
+
+/**
+ * Serialise everything the file scan determines of a NewGRF.
+ * @param config The scanned NewGRF.
+ * @return The serialised scan result.
+ */
+static std::string SerialiseGRFScanResult(const GRFConfig &config)
+{
+	std::string data;
+	StringBuilder builder(data);
+
+	WriteGRFScanBytes(builder, config.ident.grfid);
+	WriteGRFScanBytes(builder, config.ident.md5sum);
+	WriteGRFScanTextList(builder, config.name == nullptr ? GRFTextList{} : *config.name);
+	WriteGRFScanTextList(builder, config.info == nullptr ? GRFTextList{} : *config.info);
+	WriteGRFScanTextList(builder, config.url == nullptr ? GRFTextList{} : *config.url);
+	builder.PutUint32LE(config.version);
+	builder.PutUint32LE(config.min_loadable_version);
+	builder.PutUint8(config.flags.base());
+	builder.PutUint8(config.num_valid_params);
+	builder.PutUint8(config.palette);
+	builder.PutUint8(config.has_param_defaults);
+
+	builder.PutUint32LE(static_cast<uint32_t>(config.param_info.size()));
+	for (const auto &info : config.param_info) {
+		builder.PutUint8(info.has_value());
+		if (!info.has_value()) continue;
+
+		builder.PutUint8(info->param_nr);
+		WriteGRFScanTextList(builder, info->name);
+		WriteGRFScanTextList(builder, info->desc);
+		builder.PutUint32LE(info->min_value);
+		builder.PutUint32LE(info->max_value);
+		builder.PutUint32LE(info->def_value);
+		builder.PutUint8(to_underlying(info->type));
+		builder.PutUint8(info->first_bit);
+		builder.PutUint8(info->num_bit);
+		builder.PutUint8(info->complete_labels);
+		builder.PutUint32LE(static_cast<uint32_t>(info->value_names.size()));
+		for (const auto &[value, name] : info->value_names) {
+			builder.PutUint32LE(value);
+			WriteGRFScanTextList(builder, name);
+		}
+	}
+
+	builder.PutUint32LE(static_cast<uint32_t>(config.param.size()));
+	for (uint32_t value : config.param) builder.PutUint32LE(value);
+
+	return data;
+}
+
+/**
+ * Restore the scan result of a NewGRF.
+ * @param data The serialised scan result.
+ * @param[out] config The NewGRF to restore the scan result in; only its filename is set.
+ * @return True iff the scan result was complete.
+ */
+static bool DeserialiseGRFScanResult(std::string_view data, GRFConfig &config)
+{
+	GRFScanCacheReader reader(data);
+
+	reader.ReadBytes(config.ident.grfid);
+	reader.ReadBytes(config.ident.md5sum);
+	ReadGRFScanTextList(reader, config.name);
+	ReadGRFScanTextList(reader, config.info);
+	ReadGRFScanTextList(reader, config.url);
+	config.version = reader.ReadUint32();
+	config.min_loadable_version = reader.ReadUint32();
+	config.flags = GRFConfigFlags(reader.ReadUint8());
+	config.num_valid_params = reader.ReadUint8();
+	config.palette = reader.ReadUint8();
+	config.has_param_defaults = reader.ReadUint8() != 0;
+
+	uint32_t count = reader.ReadUint32();
+	for (uint32_t i = 0; i < count && !reader.error; i++) {
+		if (reader.ReadUint8() == 0) {
+			config.param_info.emplace_back();
+			continue;
+		}
+
+		GRFParameterInfo &info = *config.param_info.emplace_back(std::in_place, reader.ReadUint8());
+		ReadGRFScanTextList(reader, info.name);
+		ReadGRFScanTextList(reader, info.desc);
+		info.min_value = reader.ReadUint32();
+		info.max_value = reader.ReadUint32();
+		info.def_value = reader.ReadUint32();
+		info.type = static_cast<GRFParameterType>(reader.ReadUint8());
+		info.first_bit = reader.ReadUint8();
+		info.num_bit = reader.ReadUint8();
+		info.complete_labels = reader.ReadUint8() != 0;
+		uint32_t names = reader.ReadUint32();
+		for (uint32_t j = 0; j < names && !reader.error; j++) {
+			auto &[value, name] = info.value_names.emplace_back();
+			value = reader.ReadUint32();
+			ReadGRFScanTextList(reader, name);
+		}
+	}
+
+	count = reader.ReadUint32();
+	for (uint32_t i = 0; i < count && !reader.error; i++) config.param.push_back(reader.ReadUint32());
+
+	return !reader.error && !reader.consumer.AnyBytesLeft();
+}
+
+/**
+ * Get the name of the cache file.
+ * @return The full path of the cache file.
+ */
+static std::string GetGRFScanCacheFilename()
+{
+	return fmt::format("{}newgrf_scan.cache", _personal_dir);
+}
+
+/** Read the cache file, if that has not been done yet. */
+static void LoadGRFScanCache()
+{
+	if (_grf_scan_cache.loaded) return;
+	_grf_scan_cache.loaded = true;
+
+	std::string filename = GetGRFScanCacheFilename();
+	size_t length;
+	std::unique_ptr<char[]> mem = ReadFileToMem(filename, length, GRF_SCAN_CACHE_MAX_SIZE);
+	if (mem == nullptr) return;
+
+	/* NewGRFs might be read differently by another version, so its results are not used. */
+	GRFScanCacheReader reader(std::string_view{mem.get(), length});
+	if (reader.ReadUint32() != GRF_SCAN_CACHE_MAGIC || reader.ReadUint32() != GRF_SCAN_CACHE_VERSION || reader.ReadString() != _openttd_revision) {
+		Debug(grf, 1, "Ignoring NewGRF scan cache {} of another version", filename);
+		return;
+	}
+
+	uint32_t count = reader.ReadUint32();
+	for (uint32_t i = 0; i < count && !reader.error; i++) {
+		std::string path{reader.ReadString()};
+		GRFScanCacheEntry entry;
+		entry.stamp.size = reader.ReadUint64();
+		entry.stamp.mtime = static_cast<int64_t>(reader.ReadUint64());
+		entry.data = reader.ReadString();
+		if (!reader.error) _grf_scan_cache.entries[std::move(path)] = std::move(entry);
+	}
+
+	if (reader.error) {
+		Debug(grf, 0, "NewGRF scan cache {} is damaged; ignoring it", filename);
+		_grf_scan_cache.entries.clear();
+		return;
+	}
+	Debug(grf, 1, "Read NewGRF scan cache {} with {} files", filename, _grf_scan_cache.entries.size());
+}
+
+/**
+ * Get the size and modification time of a file.
+ * @param filename The full path of the file.
+ * @return The size and modification time, or \c std::nullopt if they could not be determined.
+ */
+std::optional<GRFScanStamp> GetGRFScanStamp(const std::string &filename)
+{
+	std::error_code error_code;
+	std::filesystem::path path(OTTD2FS(filename));
+
+	uintmax_t size = std::filesystem::file_size(path, error_code);
+	if (error_code) return std::nullopt;
+	std::filesystem::file_time_type mtime = std::filesystem::last_write_time(path, error_code);
+	if (error_code) return std::nullopt;
+
+	return GRFScanStamp{static_cast<uint64_t>(size), static_cast<int64_t>(mtime.time_since_epoch().count())};
+}
+
+/**
+ * Get the cached scan result of a file.
+ * @param path The full path of the file.
+ * @param stamp The current size and modification time of the file.
+ * @param[out] config The NewGRF to restore the scan result in; only its filename is set.
+ * @return Whether the file is a usable NewGRF, or \c std::nullopt if it needs to be scanned.
+ *         In the latter case \a config might be partially filled.
+ */
+std::optional<bool> ReadGRFFromScanCache(const std::string &path, const GRFScanStamp &stamp, GRFConfig &config)
+{
+	if (!_newgrf_scan_cache) return std::nullopt;
+	LoadGRFScanCache();
+
+	auto it = _grf_scan_cache.entries.find(path);
+	if (it == _grf_scan_cache.entries.end() || it->second.stamp != stamp) return std::nullopt;
+
+	GRFScanCacheEntry &entry = it->second;
+	if (!entry.data.empty() && !DeserialiseGRFScanResult(entry.data, config)) return std::nullopt;
+
+	entry.used = true;
+	return !entry.data.empty();
+}
+
+/**
+ * Remember the scan result of a file.
+ * @param path The full path of the file.
+ * @param stamp The size and modification time of the file when it was scanned.
+ * @param config The scanned NewGRF, or \c nullptr when the file is not a usable NewGRF.
+ */
+void AddGRFToScanCache(const std::string &path, const GRFScanStamp &stamp, const GRFConfig *config)
+{
+	if (!_newgrf_scan_cache) return;
+	/* Errors of a NewGRF are not cached, so the file is read again to show them. */
+	if (config != nullptr && !config->errors.empty()) return;
+	LoadGRFScanCache();
+
+	GRFScanCacheEntry &entry = _grf_scan_cache.entries[path];
+	entry.stamp = stamp;
+	entry.data = config == nullptr ? std::string{} : SerialiseGRFScanResult(*config);
+	entry.used = true;
+	_grf_scan_cache.dirty = true;
+}
+
+/** Write the scan results of the files found during the last scan to the cache file, if anything changed. */
+void SaveGRFScanCache()
+{
+	if (!_newgrf_scan_cache || !_grf_scan_cache.loaded) return;
+
+	/* Forget the files that have been removed. */
+	if (std::erase_if(_grf_scan_cache.entries, [](const auto &it) { return !it.second.used; }) != 0) _grf_scan_cache.dirty = true;
+	for (auto &[path, entry] : _grf_scan_cache.entries) entry.used = false;
+
+	if (!_grf_scan_cache.dirty) return;
+	_grf_scan_cache.dirty = false;
+
+	std::string data;
+	StringBuilder builder(data);
+	builder.PutUint32LE(GRF_SCAN_CACHE_MAGIC);
+	builder.PutUint32LE(GRF_SCAN_CACHE_VERSION);
+	WriteGRFScanString(builder, _openttd_revision);
+	builder.PutUint32LE(static_cast<uint32_t>(_grf_scan_cache.entries.size()));
+	for (const auto &[path, entry] : _grf_scan_cache.entries) {
+		WriteGRFScanString(builder, path);
+		builder.PutUint64LE(entry.stamp.size);
+		builder.PutUint64LE(static_cast<uint64_t>(entry.stamp.mtime));
+		WriteGRFScanString(builder, entry.data);
+	}
+
+	std::string filename = GetGRFScanCacheFilename();
+	auto f = FileHandle::Open(filename, "wb");
+	if (!f.has_value() || fwrite(data.data(), data.size(), 1, *f) != 1) {
+		Debug(grf, 0, "Could not write NewGRF scan cache {}", filename);
+		return;
+	}
+	Debug(grf, 1, "Wrote NewGRF scan cache {} with {} files", filename, _grf_scan_cache.entries.size());
+}
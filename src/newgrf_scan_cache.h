@@ -0,0 +1,28 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file newgrf_scan_cache.h Cache of the results of scanning NewGRF files, so unchanged files do not need to be read again. */
+
+#ifndef NEWGRF_SCAN_CACHE_H
+#define NEWGRF_SCAN_CACHE_H
+
+#include "newgrf_config.h"
+
+/** Size and modification time of a file, to see whether it changed since it was scanned. */
+struct GRFScanStamp {
+	uint64_t size; ///< Size of the file.
+	int64_t mtime; ///< Modification time of the file, in the units of the file system clock.
+
+	bool operator==(const GRFScanStamp &other) const = default;
+};
+
+std::optional<GRFScanStamp> GetGRFScanStamp(const std::string &filename);
+std::optional<bool> ReadGRFFromScanCache(const std::string &path, const GRFScanStamp &stamp, GRFConfig &config);
+void AddGRFToScanCache(const std::string &path, const GRFScanStamp &stamp, const GRFConfig *config);
+void SaveGRFScanCache();
+
+#endif /* NEWGRF_SCAN_CACHE_H */
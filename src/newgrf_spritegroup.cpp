@@ -139,21 +139,38 @@ static inline uint32_t GetVariable(const ResolverObject &object, ScopeResolver *
 	return &this->default_scope;
 }
 
-/* Evaluate an adjustment for a variable of the given size.
- * U is the unsigned type and S is the signed type to use. */
-template <typename U, typename S>
-static U EvalAdjustT(const DeterministicSpriteGroupAdjust &adjust, ResolverObject &object, ScopeResolver *scope, U last_value, uint32_t value)
+/**
+ * Shift, mask and adjust the input value of an adjustment.
+ * S is the signed type to use.
+ * @param value The input value.
+ * @param shift_num The shift of the input value.
+ * @param and_mask The mask of the input value.
+ * @param type The adjustment of the input value.
+ * @param add_val The addition to the input value.
+ * @param divmod_val The divisor of the input value.
+ * @return The adjusted input value.
+ */
+template <typename S>
+static inline uint32_t AdjustValueT(uint32_t value, uint8_t shift_num, uint32_t and_mask, DeterministicSpriteGroupAdjustType type, uint32_t add_val, uint32_t divmod_val)
 {
-	value >>= adjust.shift_num;
-	value  &= adjust.and_mask;
+	value >>= shift_num;
+	value  &= and_mask;
 
-	switch (adjust.type) {
-		case DeterministicSpriteGroupAdjustType::Div: value = ((S)value + (S)adjust.add_val) / (S)adjust.divmod_val; break;
-		case DeterministicSpriteGroupAdjustType::Mod: value = ((S)value + (S)adjust.add_val) % (S)adjust.divmod_val; break;
+	switch (type) {
+		case DeterministicSpriteGroupAdjustType::Div: value = ((S)value + (S)add_val) / (S)divmod_val; break;
+		case DeterministicSpriteGroupAdjustType::Mod: value = ((S)value + (S)add_val) % (S)divmod_val; break;
 		case DeterministicSpriteGroupAdjustType::None: break;
 	}
+	return value;
+}
 
-	switch (adjust.operation) {
+/* Evaluate the operation of an adjustment for a variable of the given size.
+ * U is the unsigned type and S is the signed type to use.
+ * The stores of Sto and Stop are left to the caller, as they are the only operations with side effects. */
+template <typename U, typename S>
+static inline U EvalOperationT(DeterministicSpriteGroupAdjustOperation operation, U last_value, uint32_t value)
+{
+	switch (operation) {
 		case DeterministicSpriteGroupAdjustOperation::Add: return last_value + value;
 		case DeterministicSpriteGroupAdjustOperation::Sub: return last_value - value;
 		case DeterministicSpriteGroupAdjustOperation::SMin: return std::min<S>(last_value, value);
@@ -168,9 +185,9 @@ static U EvalAdjustT(const DeterministicSpriteGroupAdjust &adjust, ResolverObjec
 		case DeterministicSpriteGroupAdjustOperation::And: return last_value & value;
 		case DeterministicSpriteGroupAdjustOperation::Or: return last_value | value;
 		case DeterministicSpriteGroupAdjustOperation::Xor: return last_value ^ value;
-		case DeterministicSpriteGroupAdjustOperation::Sto: object.SetRegister((U)value, (S)last_value); return last_value;
+		case DeterministicSpriteGroupAdjustOperation::Sto: return last_value;
 		case DeterministicSpriteGroupAdjustOperation::Rst: return value;
-		case DeterministicSpriteGroupAdjustOperation::Stop: scope->StorePSA((U)value, (S)last_value); return last_value;
+		case DeterministicSpriteGroupAdjustOperation::Stop: return last_value;
 		case DeterministicSpriteGroupAdjustOperation::Ror: return std::rotr<uint32_t>((U)last_value, (U)value & 0x1F); // mask 'value' to 5 bits, which should behave the same on all architectures.
 		case DeterministicSpriteGroupAdjustOperation::SCmp: return ((S)last_value == (S)value) ? 1 : ((S)last_value < (S)value ? 0 : 2);
 		case DeterministicSpriteGroupAdjustOperation::UCmp: return ((U)last_value == (U)value) ? 1 : ((U)last_value < (U)value ? 0 : 2);
@@ -181,18 +198,53 @@ static U EvalAdjustT(const DeterministicSpriteGroupAdjust &adjust, ResolverObjec
 	}
 }
 
+/**
+ * Do the stores of the Sto and Stop operations.
+ * U is the unsigned type and S is the signed type to use.
+ * @param operation The operation.
+ * @param object The object being resolved.
+ * @param scope The scope of the sprite group.
+ * @param last_value The last value.
+ * @param value The adjusted input value.
+ */
+template <typename U, typename S>
+static inline void EvalStoreT(DeterministicSpriteGroupAdjustOperation operation, ResolverObject &object, ScopeResolver *scope, U last_value, uint32_t value)
+{
+	if (operation == DeterministicSpriteGroupAdjustOperation::Sto) {
+		object.SetRegister((U)value, (S)last_value);
+	} else if (operation == DeterministicSpriteGroupAdjustOperation::Stop) {
+		scope->StorePSA((U)value, (S)last_value);
+	}
+}
+
+/* Evaluate an adjustment for a variable of the given size.
+ * U is the unsigned type and S is the signed type to use. */
+template <typename U, typename S>
+static U EvalAdjustT(const DeterministicSpriteGroupAdjust &adjust, ResolverObject &object, ScopeResolver *scope, U last_value, uint32_t value)
+{
+	value = AdjustValueT<S>(value, adjust.shift_num, adjust.and_mask, adjust.type, adjust.add_val, adjust.divmod_val);
+	EvalStoreT<U, S>(adjust.operation, object, scope, last_value, value);
+	return EvalOperationT<U, S>(adjust.operation, last_value, value);
+}
+
 
 static bool RangeHighComparator(const DeterministicSpriteGroupRange &range, uint32_t value)
 {
 	return range.high < value;
 }
 
-/* virtual */ ResolverResult DeterministicSpriteGroup::Resolve(ResolverObject &object) const
+/**
+ * Evaluate the adjusts of the sprite group by interpreting them one by one.
+ * This is the reference for the compiled #program.
+ * @param object The object being resolved.
+ * @param scope The scope of the sprite group.
+ * @param[out] value The resulting value.
+ * @return False iff a variable is not available.
+ */
+bool DeterministicSpriteGroup::EvaluateAdjusts(ResolverObject &object, ScopeResolver *scope, uint32_t &value) const
 {
 	uint32_t last_value = 0;
-	uint32_t value = 0;
-
-	ScopeResolver *scope = object.GetScope(this->var_scope);
+	value = 0;
 
 	for (const auto &adjust : this->adjusts) {
 		/* Try to get the variable. We shall assume it is available, unless told otherwise. */
@@ -209,11 +261,8 @@ static bool RangeHighComparator(const DeterministicSpriteGroupRange &range, uint
 			value = GetVariable(object, scope, adjust.variable, adjust.parameter, available);
 		}
 
-		if (!available) {
-			/* Unsupported variable: skip further processing and return either
-			 * the group from the first range or the default group. */
-			return SpriteGroup::Resolve(this->error_group, object, false);
-		}
+		/* Unsupported variable: skip further processing. */
+		if (!available) return false;
 
 		switch (this->size) {
 			case DeterministicSpriteGroupSize::Byte: value = EvalAdjustT<uint8_t, int8_t>(adjust, object, scope, last_value, value); break;
@@ -224,35 +273,368 @@ static bool RangeHighComparator(const DeterministicSpriteGroupRange &range, uint
 		last_value = value;
 	}
 
-	object.last_value = last_value;
+	return true;
+}
+
+/**
+ * Execute the compiled program of the sprite group for a variable of the given size.
+ * U is the unsigned type and S is the signed type to use.
+ * @param object The object being resolved.
+ * @param scope The scope of the sprite group.
+ * @param[out] value The resulting value.
+ * @return False iff a variable is not available.
+ */
+template <typename U, typename S>
+bool DeterministicSpriteGroup::ExecuteProgramT(ResolverObject &object, ScopeResolver *scope, uint32_t &value) const
+{
+	uint32_t last_value = 0;
+
+	for (const DeterministicSpriteGroupInstruction &instr : this->program) {
+		bool available = true;
+		switch (instr.input) {
+			case DeterministicSpriteGroupInput::Constant: value = instr.constant; break;
+			case DeterministicSpriteGroupInput::Callback: value = object.callback; break;
+			case DeterministicSpriteGroupInput::CallbackParam1: value = object.callback_param1; break;
+			case DeterministicSpriteGroupInput::CallbackParam2: value = object.callback_param2; break;
+			case DeterministicSpriteGroupInput::LastValue: value = object.last_value; break;
+			case DeterministicSpriteGroupInput::Random: value = (scope->GetRandomBits() << 8) | scope->GetRandomTriggers(); break;
+			case DeterministicSpriteGroupInput::Register: value = object.GetRegister(instr.parameter); break;
+			case DeterministicSpriteGroupInput::Parameter: value = object.grffile == nullptr ? 0 : object.grffile->GetParam(instr.parameter); break;
+
+			case DeterministicSpriteGroupInput::Procedure: {
+				/* Calling the procedure directly skips the profiler, so only do that when nothing is profiled. */
+				auto subgroup = instr.procedure != nullptr && _newgrf_profilers.empty() ?
+						instr.procedure->DeterministicSpriteGroup::Resolve(object) : SpriteGroup::Resolve(instr.subroutine, object, false);
+				auto *subvalue = std::get_if<CallbackResult>(&subgroup);
+				value = subvalue != nullptr ? *subvalue : UINT16_MAX;
+				break;
+			}
+
+			case DeterministicSpriteGroupInput::ConstantProcedure:
+				value = instr.constant;
+				object.last_value = instr.last_value;
+				break;
+
+			case DeterministicSpriteGroupInput::Indirect: value = GetVariable(object, scope, instr.variable, last_value, available); break;
+			case DeterministicSpriteGroupInput::Global: value = GetVariable(object, scope, instr.variable, instr.parameter, available); break;
+			case DeterministicSpriteGroupInput::Scope: value = scope->GetVariable(instr.variable, instr.parameter, available); break;
+			default: NOT_REACHED();
+		}
+
+		/* Unsupported variable: skip further processing. */
+		if (!available) return false;
+
+		if (instr.input != DeterministicSpriteGroupInput::Constant) {
+			value = AdjustValueT<S>(value, instr.shift_num, instr.and_mask, instr.type, instr.add_val, instr.divmod_val);
+		}
+		EvalStoreT<U, S>(instr.operation, object, scope, last_value, value);
+		value = EvalOperationT<U, S>(instr.operation, last_value, value);
+		last_value = value;
+	}
+
+	return true;
+}
 
-	auto result = this->default_result;
+/**
+ * Execute the compiled program of the sprite group.
+ * @param object The object being resolved.
+ * @param scope The scope of the sprite group.
+ * @param[out] value The resulting value.
+ * @return False iff a variable is not available.
+ */
+bool DeterministicSpriteGroup::ExecuteProgram(ResolverObject &object, ScopeResolver *scope, uint32_t &value) const
+{
+	value = 0;
+	switch (this->size) {
+		case DeterministicSpriteGroupSize::Byte: return this->ExecuteProgramT<uint8_t, int8_t>(object, scope, value);
+		case DeterministicSpriteGroupSize::Word: return this->ExecuteProgramT<uint16_t, int16_t>(object, scope, value);
+		case DeterministicSpriteGroupSize::DWord: return this->ExecuteProgramT<uint32_t, int32_t>(object, scope, value);
+		default: NOT_REACHED();
+	}
+}
 
+/**
+ * Get the result of the range that contains a value.
+ * @param value The value of the adjusts.
+ * @return The result of the range, or the default result.
+ */
+DeterministicSpriteGroupResult DeterministicSpriteGroup::GetRangeResult(uint32_t value) const
+{
 	if (this->ranges.size() > 4) {
 		const auto &lower = std::lower_bound(this->ranges.begin(), this->ranges.end(), value, RangeHighComparator);
 		if (lower != this->ranges.end() && lower->low <= value) {
 			assert(lower->low <= value && value <= lower->high);
-			result = lower->result;
+			return lower->result;
 		}
 	} else {
 		for (const auto &range : this->ranges) {
-			if (range.low <= value && value <= range.high) {
-				result = range.result;
-				break;
+			if (range.low <= value && value <= range.high) return range.result;
+		}
+	}
+	return this->default_result;
+}
+
+/* virtual */ ResolverResult DeterministicSpriteGroup::Resolve(ResolverObject &object) const
+{
+	ScopeResolver *scope = object.FindScope(this->var_scope);
+
+	uint32_t value;
+	bool available;
+	if (!this->compiled) {
+		available = this->EvaluateAdjusts(object, scope, value);
+	} else if (this->constant) {
+		value = this->constant_value;
+		available = true;
+	} else {
+		/* Procedures overwrite the last value, which variable 0x1C reads; so the check must start from the same one. */
+		uint32_t last_value = object.last_value;
+		available = this->ExecuteProgram(object, scope, value);
+
+		/* With debug level grf=5 or higher, check the compiled program against the interpreted adjusts.
+		 * Running them twice is only harmless without side effects. */
+		if (this->pure && _debug_grf_level >= 5) {
+			object.last_value = last_value;
+			uint32_t expected;
+			bool expected_available = this->EvaluateAdjusts(object, scope, expected);
+			if (available != expected_available || (available && value != expected)) {
+				Debug(grf, 0, "Compiled sprite group {} (nfo line {}) resolved to {}/{} instead of {}/{}", this->index, this->nfo_line, available, value, expected_available, expected);
 			}
 		}
 	}
 
+	if (!available) {
+		/* Unsupported variable: return either the group from the first range or the default group. */
+		return SpriteGroup::Resolve(this->error_group, object, false);
+	}
+
+	object.last_value = value;
+
+	DeterministicSpriteGroupResult result = this->GetRangeResult(value);
 	if (result.calculated_result) {
 		return static_cast<CallbackResult>(GB(value, 0, 15));
 	}
 	return SpriteGroup::Resolve(result.group, object, false);
 }
 
+/**
+ * Get the value of a variable that is the same for every object and all the time.
+ * @param variable The variable.
+ * @return The value, or \c std::nullopt if the variable is not constant.
+ */
+static std::optional<uint32_t> GetConstantVariable(uint8_t variable)
+{
+	switch (variable) {
+		case 0x0B: // TTDPatch version
+		case 0x11: // Current rail tool type
+		case 0x1A: // Always -1
+		case 0x1B: // Display options
+		case 0x1D: { // TTD platform
+			/* None of these depend on the NewGRF. */
+			uint32_t value;
+			if (GetGlobalVariable(variable, &value, nullptr)) return value;
+			return std::nullopt;
+		}
+
+		default:
+			return std::nullopt;
+	}
+}
+
+/**
+ * Get the result of a procedure that always gives the same result, without side effects.
+ * @param procedure The procedure.
+ * @return The result of the procedure, or \c std::nullopt if it is not constant.
+ */
+static std::optional<uint32_t> GetConstantProcedureResult(const DeterministicSpriteGroup &procedure)
+{
+	if (!procedure.compiled || !procedure.constant) return std::nullopt;
+
+	DeterministicSpriteGroupResult result = procedure.GetRangeResult(procedure.constant_value);
+	if (result.calculated_result) return GB(procedure.constant_value, 0, 15);
+	if (result.group == nullptr) return UINT16_MAX;
+
+	const auto *callback = dynamic_cast<const CallbackResultSpriteGroup *>(result.group);
+	if (callback != nullptr) return callback->result;
+	return std::nullopt;
+}
+
+/**
+ * Check whether resolving a sprite group has no side effects besides setting the last value.
+ * Deterministic sprite groups are only known to be pure once they are compiled.
+ * @param group The sprite group.
+ * @return True iff the sprite group is known to be pure.
+ */
+static bool IsPureSpriteGroup(const SpriteGroup *group)
+{
+	if (group == nullptr) return true;
+	if (const auto *deterministic = dynamic_cast<const DeterministicSpriteGroup *>(group); deterministic != nullptr) {
+		return deterministic->compiled && deterministic->pure;
+	}
+	/* Randomized sprite groups reseed and use up the random triggers. */
+	return dynamic_cast<const RandomizedSpriteGroup *>(group) == nullptr;
+}
+
+/**
+ * Fold an instruction with a constant input into a known last value.
+ * @param size The size of the variables of the sprite group.
+ * @param instr The instruction.
+ * @param last_value The last value.
+ * @return The new last value.
+ */
+static uint32_t FoldInstruction(DeterministicSpriteGroupSize size, const DeterministicSpriteGroupInstruction &instr, uint32_t last_value)
+{
+	switch (size) {
+		case DeterministicSpriteGroupSize::Byte: return EvalOperationT<uint8_t, int8_t>(instr.operation, last_value, instr.constant);
+		case DeterministicSpriteGroupSize::Word: return EvalOperationT<uint16_t, int16_t>(instr.operation, last_value, instr.constant);
+		case DeterministicSpriteGroupSize::DWord: return EvalOperationT<uint32_t, int32_t>(instr.operation, last_value, instr.constant);
+		default: NOT_REACHED();
+	}
+}
+
+/**
+ * Compile the adjusts into a program for a faster resolve.
+ * The variables are decoded into their source once, constant inputs are adjusted once, and adjusts
+ * with only constant inputs are folded away. Procedures that are deterministic sprite groups are
+ * called directly, or folded into a constant when they always give the same result.
+ * Procedures must be compiled before the sprite groups that use them.
+ */
+void DeterministicSpriteGroup::Compile()
+{
+	this->program.clear();
+	this->pure = true;
+
+	uint32_t known_last_value = 0; ///< The last value, as far as it is known.
+	bool known = true; ///< Whether \c known_last_value is the last value.
+	bool synced = true; ///< Whether the program leaves \c known_last_value as last value.
+
+	for (const DeterministicSpriteGroupAdjust &adjust : this->adjusts) {
+		DeterministicSpriteGroupInstruction instr;
+		instr.operation = adjust.operation;
+		instr.type = adjust.type;
+		instr.variable = adjust.variable;
+		instr.parameter = adjust.parameter;
+		instr.shift_num = adjust.shift_num;
+		instr.and_mask = adjust.and_mask;
+		instr.add_val = adjust.add_val;
+		instr.divmod_val = adjust.divmod_val;
+		instr.subroutine = adjust.subroutine;
+
+		std::optional<uint32_t> constant_input;
+		switch (adjust.variable) {
+			case 0x0C: instr.input = DeterministicSpriteGroupInput::Callback; break;
+			case 0x10: instr.input = DeterministicSpriteGroupInput::CallbackParam1; break;
+			case 0x18: instr.input = DeterministicSpriteGroupInput::CallbackParam2; break;
+			case 0x1C: instr.input = DeterministicSpriteGroupInput::LastValue; break;
+			case 0x5F: instr.input = DeterministicSpriteGroupInput::Random; break;
+			case 0x7D: instr.input = DeterministicSpriteGroupInput::Register; break;
+			case 0x7F: instr.input = DeterministicSpriteGroupInput::Parameter; break;
+
+			case 0x7B:
+				instr.input = DeterministicSpriteGroupInput::Indirect;
+				instr.variable = adjust.parameter;
+				break;
+
+			case 0x7E: {
+				instr.input = DeterministicSpriteGroupInput::Procedure;
+				instr.procedure = dynamic_cast<const DeterministicSpriteGroup *>(adjust.subroutine);
+				if (adjust.subroutine == nullptr) {
+					constant_input = UINT16_MAX;
+				} else if (const auto *callback = dynamic_cast<const CallbackResultSpriteGroup *>(adjust.subroutine); callback != nullptr) {
+					constant_input = callback->result;
+				} else if (instr.procedure == nullptr || !instr.procedure->compiled || !instr.procedure->pure) {
+					this->pure = false;
+				} else if (std::optional<uint32_t> result = GetConstantProcedureResult(*instr.procedure); result.has_value()) {
+					/* The procedure still leaves its last value behind. */
+					instr.input = DeterministicSpriteGroupInput::ConstantProcedure;
+					instr.constant = *result;
+					instr.last_value = instr.procedure->constant_value;
+				}
+				break;
+			}
+
+			default:
+				constant_input = GetConstantVariable(adjust.variable);
+				instr.input = adjust.variable < 0x40 ? DeterministicSpriteGroupInput::Global : DeterministicSpriteGroupInput::Scope;
+				break;
+		}
+
+		if (constant_input.has_value()) {
+			instr.input = DeterministicSpriteGroupInput::Constant;
+			switch (this->size) {
+				case DeterministicSpriteGroupSize::Byte: instr.constant = AdjustValueT<int8_t>(*constant_input, instr.shift_num, instr.and_mask, instr.type, instr.add_val, instr.divmod_val); break;
+				case DeterministicSpriteGroupSize::Word: instr.constant = AdjustValueT<int16_t>(*constant_input, instr.shift_num, instr.and_mask, instr.type, instr.add_val, instr.divmod_val); break;
+				case DeterministicSpriteGroupSize::DWord: instr.constant = AdjustValueT<int32_t>(*constant_input, instr.shift_num, instr.and_mask, instr.type, instr.add_val, instr.divmod_val); break;
+				default: NOT_REACHED();
+			}
+		}
+
+		bool stores = instr.operation == DeterministicSpriteGroupAdjustOperation::Sto || instr.operation == DeterministicSpriteGroupAdjustOperation::Stop;
+		if (stores) this->pure = false;
+
+		if (known && instr.input == DeterministicSpriteGroupInput::Constant && !stores) {
+			/* Nothing changes at runtime, so do it now. */
+			uint32_t folded = FoldInstruction(this->size, instr, known_last_value);
+			if (folded != known_last_value) synced = false;
+			known_last_value = folded;
+			continue;
+		}
+
+		if (!synced) {
+			/* Instructions were folded away; restore the last value they would have left behind. */
+			DeterministicSpriteGroupInstruction &restore = this->program.emplace_back();
+			restore.input = DeterministicSpriteGroupInput::Constant;
+			restore.operation = DeterministicSpriteGroupAdjustOperation::Rst;
+			restore.constant = known_last_value;
+			synced = true;
+		}
+
+		this->program.push_back(instr);
+		known = known && instr.input == DeterministicSpriteGroupInput::Constant && stores;
+	}
+
+	/* A procedure call resolves the ranges as well, so they must be free of side effects too. */
+	if (this->pure) {
+		this->pure = IsPureSpriteGroup(this->error_group) && IsPureSpriteGroup(this->default_result.group) &&
+				std::ranges::all_of(this->ranges, [](const DeterministicSpriteGroupRange &range) { return IsPureSpriteGroup(range.result.group); });
+	}
+
+	this->constant = this->program.empty();
+	this->constant_value = known_last_value;
+
+	if (!this->constant && !synced) {
+		DeterministicSpriteGroupInstruction &restore = this->program.emplace_back();
+		restore.input = DeterministicSpriteGroupInput::Constant;
+		restore.operation = DeterministicSpriteGroupAdjustOperation::Rst;
+		restore.constant = known_last_value;
+	}
+
+	this->compiled = true;
+}
+
+/**
+ * Compile all deterministic sprite groups, after all NewGRFs are loaded so the procedures are complete.
+ * Sprite groups can only refer to groups that were made before them, so going through the pool in
+ * order compiles the procedures before the sprite groups that use them.
+ */
+void CompileSpriteGroups()
+{
+	size_t instructions = 0;
+	size_t adjusts = 0;
+	for (SpriteGroup *group : SpriteGroup::Iterate()) {
+		auto *deterministic = dynamic_cast<DeterministicSpriteGroup *>(group);
+		if (deterministic == nullptr) continue;
+
+		deterministic->Compile();
+		adjusts += deterministic->adjusts.size();
+		instructions += deterministic->program.size();
+	}
+	Debug(grf, 2, "Compiled {} adjusts of deterministic sprite groups into {} instructions", adjusts, instructions);
+}
+
 
 /* virtual */ ResolverResult RandomizedSpriteGroup::Resolve(ResolverObject &object) const
 {
-	ScopeResolver *scope = object.GetScope(this->var_scope, this->count);
+	ScopeResolver *scope = object.FindScope(this->var_scope, this->count);
 	if (object.callback == CBID_RANDOM_TRIGGER) {
 		/* Handle triggers */
 		uint8_t match = this->triggers & object.GetWaitingRandomTriggers();
@@ -22,10 +22,12 @@
 #include "newgrf_commons.h"
 
 struct SpriteGroup;
+struct DeterministicSpriteGroup;
 struct ResultSpriteGroup;
 struct TileLayoutSpriteGroup;
 struct IndustryProductionSpriteGroup;
 struct ResolverObject;
+struct ScopeResolver;
 using CallbackResult = uint16_t;
 
 /**
@@ -178,6 +180,43 @@ struct DeterministicSpriteGroupAdjust {
 };
 
 
+/** Source of the input value of an instruction of a compiled #DeterministicSpriteGroup. */
+enum class DeterministicSpriteGroupInput : uint8_t {
+	Constant, ///< Value known when compiling; already shifted, masked and adjusted.
+	Callback, ///< Variable 0x0C: the callback being resolved.
+	CallbackParam1, ///< Variable 0x10: first parameter of the callback.
+	CallbackParam2, ///< Variable 0x18: second parameter of the callback.
+	LastValue, ///< Variable 0x1C: result of the most recent deterministic sprite group.
+	Random, ///< Variable 0x5F: random bits and triggers of the scope.
+	Register, ///< Variable 0x7D: a temporary register.
+	Parameter, ///< Variable 0x7F: a parameter of the NewGRF.
+	Procedure, ///< Variable 0x7E: result of a procedure.
+	ConstantProcedure, ///< Variable 0x7E: result of a procedure that always gives the same result.
+	Indirect, ///< Variable 0x7B: a variable with the last value as parameter.
+	Global, ///< Variable below 0x40: a global variable, or else a variable of the scope.
+	Scope, ///< Variable of the scope.
+};
+
+/**
+ * Instruction of a compiled #DeterministicSpriteGroup.
+ * It is a #DeterministicSpriteGroupAdjust with the variable already decoded into its source.
+ */
+struct DeterministicSpriteGroupInstruction {
+	DeterministicSpriteGroupInput input{}; ///< Source of the input value.
+	DeterministicSpriteGroupAdjustOperation operation{}; ///< Operation on the last value and the input value.
+	DeterministicSpriteGroupAdjustType type{}; ///< Adjustment of the input value.
+	uint8_t variable = 0; ///< Variable to read, for #DeterministicSpriteGroupInput::Indirect, Global and Scope.
+	uint8_t parameter = 0; ///< Parameter of the variable.
+	uint8_t shift_num = 0; ///< Shift of the input value.
+	uint32_t and_mask = 0; ///< Mask of the input value.
+	uint32_t add_val = 0; ///< Addition to the input value for #DeterministicSpriteGroupAdjustType::Div and Mod.
+	uint32_t divmod_val = 0; ///< Divisor of the input value for #DeterministicSpriteGroupAdjustType::Div and Mod.
+	uint32_t constant = 0; ///< Input value for #DeterministicSpriteGroupInput::Constant and ConstantProcedure.
+	uint32_t last_value = 0; ///< Last value the procedure leaves behind, for #DeterministicSpriteGroupInput::ConstantProcedure.
+	const SpriteGroup *subroutine = nullptr; ///< The procedure, for #DeterministicSpriteGroupInput::Procedure.
+	const DeterministicSpriteGroup *procedure = nullptr; ///< The procedure if it is a deterministic sprite group, so it can be called directly.
+};
+
 struct DeterministicSpriteGroupResult {
 	bool calculated_result = false;
 	const SpriteGroup *group = nullptr;
@@ -205,8 +244,23 @@ struct DeterministicSpriteGroup : SpecializedSpriteGroup<DeterministicSpriteGrou
 
 	const SpriteGroup *error_group = nullptr; ///< Was first range, before sorting ranges.
 
+	std::vector<DeterministicSpriteGroupInstruction> program{}; ///< The #adjusts compiled by #Compile.
+	uint32_t constant_value = 0; ///< The value of the #adjusts, when it is #constant.
+	bool compiled = false; ///< Whether #program is compiled; if not the #adjusts are interpreted.
+	bool constant = false; ///< Whether the #adjusts always give the same value, without side effects.
+	bool pure = false; ///< Whether resolving the group, including its procedures and ranges, has no side effects besides setting the last value.
+
+	void Compile();
+	DeterministicSpriteGroupResult GetRangeResult(uint32_t value) const;
+
 protected:
 	ResolverResult Resolve(ResolverObject &object) const override;
+
+private:
+	bool EvaluateAdjusts(ResolverObject &object, ScopeResolver *scope, uint32_t &value) const;
+	bool ExecuteProgram(ResolverObject &object, ScopeResolver *scope, uint32_t &value) const;
+	template <typename U, typename S>
+	bool ExecuteProgramT(ResolverObject &object, ScopeResolver *scope, uint32_t &value) const;
 };
 
 /** Randomized sprite group comparisation mode. */
@@ -390,6 +444,14 @@ public:
 	const GRFFile *grffile = nullptr; ///< GRFFile the resolved SpriteGroup belongs to
 	const SpriteGroup *root_spritegroup = nullptr; ///< Root SpriteGroup to use for resolving
 
+protected:
+	/**
+	 * Scopes that #GetScope always returns for this resolver, or \c nullptr when it has to be asked.
+	 * Set by the constructors of features that are resolved often, so #FindScope can skip the virtual call.
+	 */
+	EnumIndexArray<ScopeResolver *, VarSpriteGroupScope, VarSpriteGroupScope::Relative> fixed_scopes{};
+public:
+
 	/**
 	 * Resolve SpriteGroup.
 	 * @return Result spritegroup.
@@ -438,6 +500,18 @@ public:
 
 	virtual ScopeResolver *GetScope(VarSpriteGroupScope scope = VarSpriteGroupScope::Self, uint8_t relative = 0);
 
+	/**
+	 * Get a scope like #GetScope, but without the virtual call for the scopes in #fixed_scopes.
+	 * @param scope The scope to get.
+	 * @param relative Additional parameter for #VarSpriteGroupScope::Relative.
+	 * @return The scope.
+	 */
+	inline ScopeResolver *FindScope(VarSpriteGroupScope scope, uint8_t relative = 0)
+	{
+		if (scope < VarSpriteGroupScope::Relative && this->fixed_scopes[scope] != nullptr) return this->fixed_scopes[scope];
+		return this->GetScope(scope, relative);
+	}
+
 	/**
 	 * Used by RandomizedSpriteGroup: Triggers for rerandomisation
 	 * @return The triggers waiting for randomisation.
@@ -513,4 +587,6 @@ struct SpecializedResolverObject : public ResolverObject {
 	}
 };
 
+void CompileSpriteGroups();
+
 #endif /* NEWGRF_SPRITEGROUP_H */
@@ -596,6 +596,9 @@ StationResolverObject::StationResolverObject(const StationSpec *statspec, BaseSt
 	: SpecializedResolverObject<StationRandomTriggers>(statspec->grf_prop.grffile, callback, callback_param1, callback_param2),
 	station_scope(*this, statspec, base_station, tile)
 {
+	/* The parent scope is the town, which is only looked up when it is used. */
+	this->fixed_scopes[VarSpriteGroupScope::Self] = &this->station_scope;
+
 	CargoType ctype = CargoGRFFileProps::SG_DEFAULT_NA;
 
 	if (this->station_scope.st == nullptr) {
@@ -922,12 +925,12 @@ struct StationAnimationBase : public AnimationBase<StationAnimationBase, Station
 	static constexpr StationCallbackMask cbm_animation_next_frame = StationCallbackMask::AnimationNextFrame;
 };
 
-void AnimateStationTile(TileIndex tile)
+uint AnimateStationTile(TileIndex tile)
 {
 	const StationSpec *ss = GetStationSpec(tile);
-	if (ss == nullptr) return;
+	if (ss == nullptr) return 1;
 
-	StationAnimationBase::AnimateTile(ss, BaseStation::GetByTile(tile), tile, ss->flags.Test(StationSpecFlag::Cb141RandomBits));
+	return StationAnimationBase::AnimateTile(ss, BaseStation::GetByTile(tile), tile, ss->flags.Test(StationSpecFlag::Cb141RandomBits));
 }
 
 void TriggerStationAnimation(BaseStation *st, TileIndex trigger_tile, StationAnimationTrigger trigger, CargoType cargo_type)
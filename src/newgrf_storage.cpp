@@ -18,28 +18,92 @@
 PersistentStoragePool _persistent_storage_pool("PersistentStorage");
 INSTANTIATE_POOL_METHODS(PersistentStorage)
 
-/** The changed storage arrays */
-static std::set<BasePersistentStorageArray*> *_changed_storage_arrays = new std::set<BasePersistentStorageArray*>;
+/** Value of a persistent storage array from before a temporary change. */
+struct PersistentStorageUndo {
+	BasePersistentStorageArray *storage; ///< The changed array.
+	uint pos; ///< The changed position.
+	int32_t value; ///< The value before the change.
+};
+
+static std::vector<PersistentStorageUndo> _storage_undo_log; ///< Temporary changes since the last mode switch, oldest first.
+static std::vector<BasePersistentStorageArray *> _changed_storage_arrays; ///< The arrays with temporary changes since the last mode switch.
+static uint64_t _storage_undo_generation = 1; ///< Generation of the undo log; arrays with this generation are in #_changed_storage_arrays.
+
+PersistentStorageStats BasePersistentStorageArray::tick_stats;
+static PersistentStorageStats _last_tick_storage_stats; ///< Statistics of the last complete game tick.
+static PersistentStorageStats _total_storage_stats; ///< Statistics of all complete game ticks.
 
 bool BasePersistentStorageArray::gameloop;
 bool BasePersistentStorageArray::command;
 bool BasePersistentStorageArray::testmode;
 
+/**
+ * Add the statistics of another period to these.
+ * @param other The statistics to add.
+ * @return This statistics.
+ */
+PersistentStorageStats &PersistentStorageStats::operator+=(const PersistentStorageStats &other)
+{
+	this->writes += other.writes;
+	this->temporary_writes += other.temporary_writes;
+	this->reverted_writes += other.reverted_writes;
+	this->reverted_arrays += other.reverted_arrays;
+	return *this;
+}
+
 /** Remove references to us. */
 BasePersistentStorageArray::~BasePersistentStorageArray()
 {
-	_changed_storage_arrays->erase(this);
+	if (!this->HasTemporaryChanges()) return;
+
+	std::erase_if(_storage_undo_log, [this](const PersistentStorageUndo &undo) { return undo.storage == this; });
+	std::erase(_changed_storage_arrays, this);
+}
+
+/**
+ * Record a temporary change in the undo log, so it can be reverted on the next mode switch.
+ * The array registers itself as changed on its first change of the current generation only.
+ * @param pos   The position that is written.
+ * @param value The value before the change.
+ */
+void BasePersistentStorageArray::LogChange(uint pos, int32_t value)
+{
+	if (this->generation != _storage_undo_generation) {
+		this->generation = _storage_undo_generation;
+		_changed_storage_arrays.push_back(this);
+	}
+
+	_storage_undo_log.emplace_back(this, pos, value);
+	tick_stats.temporary_writes++;
 }
 
 /**
- * Add the changed storage array to the list of changed arrays.
- * This is done so we only have to revert/save the changed
- * arrays, which saves quite a few clears, etc. after callbacks.
- * @param storage the array that has changed
+ * Check whether this array has temporary changes that will be reverted on the next mode switch.
+ * @return \c true iff there are changes in the undo log of the array.
  */
-void AddChangedPersistentStorage(BasePersistentStorageArray *storage)
+bool BasePersistentStorageArray::HasTemporaryChanges() const
 {
-	_changed_storage_arrays->insert(storage);
+	return this->generation == _storage_undo_generation;
+}
+
+/**
+ * Get the statistics of the writes to persistent storage during the last game tick.
+ * @return The statistics.
+ */
+/* static */ const PersistentStorageStats &BasePersistentStorageArray::GetLastTickStats()
+{
+	return _last_tick_storage_stats;
+}
+
+/**
+ * Get the statistics of the writes to persistent storage since the game started, including the current game tick.
+ * @return The statistics.
+ */
+/* static */ PersistentStorageStats BasePersistentStorageArray::GetTotalStats()
+{
+	PersistentStorageStats stats = _total_storage_stats;
+	stats += tick_stats;
+	return stats;
 }
 
 /**
@@ -87,10 +151,34 @@ void AddChangedPersistentStorage(BasePersistentStorageArray *storage)
 		default: NOT_REACHED();
 	}
 
-	/* Discard all temporary changes */
-	for (auto &it : *_changed_storage_arrays) {
-		Debug(desync, 2, "warning: discarding persistent storage changes: Feature {}, GrfID {}, Tile {}", it->feature, FormatArrayAsHex(it->grfid), it->tile);
-		it->ClearChanges();
+	DiscardTemporaryChanges();
+
+	if (mode == PSM_ENTER_GAMELOOP) {
+		/* A new game tick starts. */
+		_last_tick_storage_stats = tick_stats;
+		_total_storage_stats += tick_stats;
+		tick_stats = {};
 	}
-	_changed_storage_arrays->clear();
+}
+
+/**
+ * Revert all temporary changes made since the last mode switch.
+ */
+/* static */ void BasePersistentStorageArray::DiscardTemporaryChanges()
+{
+	if (_changed_storage_arrays.empty()) return;
+
+	/* Discard all temporary changes, newest first so each position gets the value from before its first change. */
+	for (auto it = _storage_undo_log.rbegin(); it != _storage_undo_log.rend(); ++it) {
+		it->storage->RevertValue(it->pos, it->value);
+	}
+	for (const BasePersistentStorageArray *storage : _changed_storage_arrays) {
+		Debug(desync, 2, "warning: discarding persistent storage changes: Feature {}, GrfID {}, Tile {}", storage->feature, FormatArrayAsHex(storage->grfid), storage->tile);
+	}
+
+	tick_stats.reverted_writes += _storage_undo_log.size();
+	tick_stats.reverted_arrays += _changed_storage_arrays.size();
+	_storage_undo_log.clear();
+	_changed_storage_arrays.clear();
+	_storage_undo_generation++;
 }
@@ -26,9 +26,24 @@ enum PersistentStorageMode : uint8_t {
 	PSM_LEAVE_TESTMODE,   ///< Leave command test mode, revert to previous mode.
 };
 
+/** Statistics about the changes to persistent storage arrays. */
+struct PersistentStorageStats {
+	uint64_t writes = 0; ///< Number of values changed.
+	uint64_t temporary_writes = 0; ///< Number of changed values that were recorded in the undo log.
+	uint64_t reverted_writes = 0; ///< Number of changed values that were reverted from the undo log.
+	uint64_t reverted_arrays = 0; ///< Number of times an array with temporary changes was reverted.
+
+	PersistentStorageStats &operator+=(const PersistentStorageStats &other);
+};
+
 /**
  * Base class for all persistent NewGRF storage arrays. Nothing fancy, only here
  * so we have a generalised access to the virtual methods.
+ *
+ * Temporary changes are not kept in backup copies of the arrays, but in one
+ * undo log of the values they overwrote. Every call to #SwitchMode reverts the
+ * log and starts a new generation of it, so an array only has to compare its
+ * generation to know whether it has temporary changes.
  */
 struct BasePersistentStorageArray {
 	GrfID grfid{}; ///< GRFID associated to this persistent storage. A value of zero means "default".
@@ -38,21 +53,34 @@ struct BasePersistentStorageArray {
 	virtual ~BasePersistentStorageArray();
 
 	static void SwitchMode(PersistentStorageMode mode, bool ignore_prev_mode = false);
+	static void DiscardTemporaryChanges();
+
+	static const PersistentStorageStats &GetLastTickStats();
+	static PersistentStorageStats GetTotalStats();
 
 protected:
 	/**
-	 * Discard temporary changes.
+	 * Discard a temporary change by putting back the overwritten value.
+	 * @param pos   The position that was written.
+	 * @param value The value before the change.
 	 */
-	virtual void ClearChanges() = 0;
+	virtual void RevertValue(uint pos, int32_t value) = 0;
+
+	void LogChange(uint pos, int32_t value);
+	bool HasTemporaryChanges() const;
 
 	/**
 	 * Check whether currently changes to the storage shall be persistent or
-	 * temporary till the next call to ClearChanges().
+	 * temporary till the next call to SwitchMode().
 	 * @return \c true iff the changes should be persisted or not. For example, when testing commands we do not persist the changes.
 	 */
 	static bool AreChangesPersistent() { return (gameloop || command) && !testmode; }
 
+	static PersistentStorageStats tick_stats; ///< Statistics of the current game tick.
+
 private:
+	uint64_t generation = 0; ///< Generation of the undo log this array last logged a change in.
+
 	static bool gameloop;
 	static bool command;
 	static bool testmode;
@@ -60,7 +88,7 @@ private:
 
 /**
  * Class for persistent storage of data.
- * On #ClearChanges that data is either reverted or saved.
+ * Temporary changes are reverted on the next call to #BasePersistentStorageArray::SwitchMode.
  * @tparam TYPE the type of variable to store.
  * @tparam SIZE the size of the array.
  */
@@ -69,12 +97,10 @@ struct PersistentStorageArray : BasePersistentStorageArray {
 	using StorageType = std::array<TYPE, SIZE>;
 
 	StorageType storage{}; ///< Memory for the storage array
-	std::unique_ptr<StorageType> prev_storage{}; ///< Temporary memory to store previous state so it can be reverted, e.g. for command tests.
 
 	/**
 	 * Stores some value at a given position.
-	 * If there is no backup of the data that backup is made and then
-	 * we write the data.
+	 * When the change is temporary the old value is put in the undo log first.
 	 * @param pos   the position to write at
 	 * @param value the value to write
 	 */
@@ -87,18 +113,14 @@ struct PersistentStorageArray : BasePersistentStorageArray {
 		 * Saves a few cycles and such and it's pretty easy to check. */
 		if (this->storage[pos] == value) return;
 
-		/* We do not have made a backup; lets do so */
 		if (AreChangesPersistent()) {
-			assert(!this->prev_storage);
-		} else if (!this->prev_storage) {
-			this->prev_storage = std::make_unique<StorageType>(this->storage);
-
-			/* We only need to register ourselves when we made the backup
-			 * as that is the only time something will have changed */
-			AddChangedPersistentStorage(this);
+			assert(!this->HasTemporaryChanges());
+		} else {
+			this->LogChange(pos, this->storage[pos]);
 		}
 
 		this->storage[pos] = value;
+		tick_stats.writes++;
 	}
 
 	/**
@@ -114,12 +136,10 @@ struct PersistentStorageArray : BasePersistentStorageArray {
 		return this->storage[pos];
 	}
 
-	void ClearChanges() override
+protected:
+	void RevertValue(uint pos, int32_t value) override
 	{
-		if (this->prev_storage) {
-			this->storage = *this->prev_storage;
-			this->prev_storage.reset();
-		}
+		this->storage[pos] = value;
 	}
 };
 
@@ -183,8 +203,6 @@ struct TemporaryStorageArray {
 	}
 };
 
-void AddChangedPersistentStorage(BasePersistentStorageArray *storage);
-
 typedef PersistentStorageArray<int32_t, 16> OldPersistentStorage;
 
 using PersistentStorageID = PoolID<uint32_t, struct PersistentStorageIDTag, 0xFF000, 0xFFFFF>;
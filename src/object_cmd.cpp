@@ -1027,7 +1027,7 @@ extern const TileTypeProcs _tile_type_object_procs = {
 	.add_accepted_cargo_proc = AddAcceptedCargo_Object,
 	.get_tile_desc_proc = GetTileDesc_Object,
 	.click_tile_proc = ClickTile_Object,
-	.animate_tile_proc = [](TileIndex tile) { AnimateNewObjectTile(tile); },
+	.animate_tile_proc = [](TileIndex tile) { return AnimateNewObjectTile(tile); },
 	.tile_loop_proc = TileLoop_Object,
 	.change_tile_owner_proc = ChangeTileOwner_Object,
 	.add_produced_cargo_proc = AddProducedCargo_Object,
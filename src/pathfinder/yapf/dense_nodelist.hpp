@@ -0,0 +1,343 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file dense_nodelist.hpp List of nodes used for the A-star pathfinder, using open addressing and a d-ary heap. */
+
+#ifndef DENSE_NODELIST_HPP
+#define DENSE_NODELIST_HPP
+
+/**
+ * Node list multi-container class with a single open addressing index.
+ *  Implements open list, closed list and priority queue for A-star pathfinder,
+ *  with the same interface as #NodeList.
+ *
+ * Open and closed nodes share one linear probing table, so looking up a key
+ * touches a few adjacent slots instead of following hash chains through the
+ * node storage. The open nodes are kept in a d-ary heap that knows the
+ * position of each node, so removing an arbitrary open node does not need
+ * a search through the heap.
+ * @tparam Titem The node type.
+ * @tparam Tarity The number of children of each heap node.
+ */
+template <class Titem, uint Tarity = 4>
+class DenseNodeList {
+public:
+	using Item = Titem;
+	using Key = typename Titem::Key;
+
+	static_assert(Tarity >= 2);
+
+protected:
+	static constexpr uint32_t POS_CLOSED = UINT32_MAX; ///< Heap position of a closed node.
+	static constexpr uint32_t POS_DETACHED = UINT32_MAX - 1; ///< Heap position of a node that is neither open nor closed.
+	static constexpr uint INITIAL_SLOT_BITS = 8; ///< Initial size of the index, in bits.
+
+	/** Slot in the index. */
+	struct Slot {
+		Titem *item; ///< The node, or \c nullptr if the slot is free.
+		uint32_t heap_pos; ///< Position of the node in the open queue, or #POS_CLOSED or #POS_DETACHED.
+	};
+
+	/** Element of the open queue. */
+	struct HeapEntry {
+		Titem *item; ///< The open node.
+		uint32_t slot; ///< Index of the slot of the node.
+	};
+
+	std::deque<Titem> items; ///< Storage of the nodes.
+	std::vector<Slot> slots; ///< Index of the open and closed nodes.
+	std::vector<HeapEntry> open_queue; ///< Priority queue of the open nodes.
+	uint used_slots = 0; ///< Number of slots in use.
+	uint slot_bits = INITIAL_SLOT_BITS; ///< Size of the index, in bits.
+	int closed_count = 0; ///< Number of closed nodes.
+	Titem *new_node = nullptr; ///< New node under construction.
+
+	/**
+	 * Get the preferred slot for a key.
+	 * @param key The key.
+	 * @return Index of the first slot to probe.
+	 */
+	inline uint32_t GetHomeSlot(const Key &key) const
+	{
+		/* Fibonacci hashing spreads the tile-major keys over the whole table. */
+		uint32_t hash = static_cast<uint32_t>(key.CalcHash()) * 0x9E3779B9U;
+		return hash >> (32 - this->slot_bits);
+	}
+
+	/**
+	 * Find the slot of a key.
+	 * @param key The key to look for.
+	 * @return Index of the slot holding the key, or of the free slot where it should be added.
+	 */
+	inline uint32_t FindSlot(const Key &key) const
+	{
+		const uint32_t mask = static_cast<uint32_t>(this->slots.size() - 1);
+		for (uint32_t index = this->GetHomeSlot(key);; index = (index + 1) & mask) {
+			const Slot &slot = this->slots[index];
+			if (slot.item == nullptr || slot.item->GetKey() == key) return index;
+		}
+	}
+
+	/** Double the size of the index. */
+	void Grow()
+	{
+		this->slot_bits++;
+		std::vector<Slot> old_slots(static_cast<size_t>(1) << this->slot_bits, Slot{nullptr, POS_DETACHED});
+		this->slots.swap(old_slots);
+		for (const Slot &slot : old_slots) {
+			if (slot.item == nullptr) continue;
+			uint32_t index = this->FindSlot(slot.item->GetKey());
+			this->slots[index] = slot;
+			if (slot.heap_pos < POS_DETACHED) this->open_queue[slot.heap_pos].slot = index;
+		}
+	}
+
+	/**
+	 * Get the slot of a key, adding it to the index when needed.
+	 * @param item The node to add.
+	 * @return Index of the slot of the node.
+	 */
+	inline uint32_t AddToIndex(Titem &item)
+	{
+		if ((this->used_slots + 1) * 2 > this->slots.size()) this->Grow();
+		uint32_t index = this->FindSlot(item.GetKey());
+		Slot &slot = this->slots[index];
+		if (slot.item == nullptr) this->used_slots++;
+		slot.item = &item;
+		return index;
+	}
+
+	/**
+	 * Put a heap entry at a position, and let its slot know.
+	 * @param pos The position in the heap.
+	 * @param entry The entry.
+	 */
+	inline void PlaceEntry(size_t pos, const HeapEntry &entry)
+	{
+		this->open_queue[pos] = entry;
+		this->slots[entry.slot].heap_pos = static_cast<uint32_t>(pos);
+	}
+
+	/**
+	 * Move an entry towards the top of the heap.
+	 * @param pos The position of the gap to fill.
+	 * @param entry The entry to place.
+	 */
+	void HeapifyUp(size_t pos, const HeapEntry &entry)
+	{
+		while (pos > 0) {
+			size_t parent = (pos - 1) / Tarity;
+			if (!(*entry.item < *this->open_queue[parent].item)) break;
+			this->PlaceEntry(pos, this->open_queue[parent]);
+			pos = parent;
+		}
+		this->PlaceEntry(pos, entry);
+	}
+
+	/**
+	 * Move an entry towards the bottom of the heap.
+	 * @param pos The position of the gap to fill.
+	 * @param entry The entry to place.
+	 */
+	void HeapifyDown(size_t pos, const HeapEntry &entry)
+	{
+		const size_t count = this->open_queue.size();
+		for (;;) {
+			size_t first_child = pos * Tarity + 1;
+			if (first_child >= count) break;
+
+			size_t best = first_child;
+			size_t last_child = std::min(first_child + Tarity, count);
+			for (size_t child = first_child + 1; child < last_child; child++) {
+				if (*this->open_queue[child].item < *this->open_queue[best].item) best = child;
+			}
+			if (!(*this->open_queue[best].item < *entry.item)) break;
+
+			this->PlaceEntry(pos, this->open_queue[best]);
+			pos = best;
+		}
+		this->PlaceEntry(pos, entry);
+	}
+
+	/**
+	 * Remove an entry from the open queue.
+	 * @param pos The position of the entry.
+	 */
+	void RemoveFromQueue(size_t pos)
+	{
+		HeapEntry last = this->open_queue.back();
+		this->open_queue.pop_back();
+		if (pos == this->open_queue.size()) return;
+
+		if (pos > 0 && *last.item < *this->open_queue[(pos - 1) / Tarity].item) {
+			this->HeapifyUp(pos, last);
+		} else {
+			this->HeapifyDown(pos, last);
+		}
+	}
+
+public:
+	/** default constructor */
+	DenseNodeList() : slots(static_cast<size_t>(1) << INITIAL_SLOT_BITS, Slot{nullptr, POS_DETACHED})
+	{
+		this->open_queue.reserve(2048);
+	}
+
+	/**
+	 * Get open node count.
+	 * @return Number of open nodes.
+	 */
+	inline int OpenCount()
+	{
+		return static_cast<int>(this->open_queue.size());
+	}
+
+	/**
+	 * Get closed node count.
+	 * @return Number of closed nodes.
+	 */
+	inline int ClosedCount()
+	{
+		return this->closed_count;
+	}
+
+	/**
+	 * Get the total node count.
+	 * @return The total number of nodes.
+	 */
+	inline int TotalCount()
+	{
+		return static_cast<int>(this->items.size());
+	}
+
+	/**
+	 * Allocate new data item from items.
+	 * @return The allocated node.
+	 */
+	inline Titem &CreateNewNode()
+	{
+		if (this->new_node == nullptr) this->new_node = &this->items.emplace_back();
+		return *this->new_node;
+	}
+
+	/**
+	 * Notify the nodelist that we don't want to discard the given node.
+	 * @param item The new best node.
+	 */
+	inline void FoundBestNode(Titem &item)
+	{
+		if (&item == this->new_node) this->new_node = nullptr;
+	}
+
+	/**
+	 * Insert given item as open node.
+	 * @param item The node to add.
+	 */
+	inline void InsertOpenNode(Titem &item)
+	{
+		uint32_t index = this->AddToIndex(item);
+		assert(this->slots[index].heap_pos == POS_DETACHED);
+		this->open_queue.emplace_back();
+		this->HeapifyUp(this->open_queue.size() - 1, HeapEntry{&item, index});
+		if (&item == this->new_node) this->new_node = nullptr;
+	}
+
+	/**
+	 * Get the open node at the begin of the open queue.
+	 * @return The best open node, or \c nullptr when there isn't any.
+	 */
+	inline Titem *GetBestOpenNode()
+	{
+		return this->open_queue.empty() ? nullptr : this->open_queue.front().item;
+	}
+
+	/**
+	 * Remove and return the best open node.
+	 * @return The best open node, or \c nullptr when there isn't any.
+	 */
+	inline Titem *PopBestOpenNode()
+	{
+		if (this->open_queue.empty()) return nullptr;
+
+		HeapEntry best = this->open_queue.front();
+		this->slots[best.slot].heap_pos = POS_DETACHED;
+		this->RemoveFromQueue(0);
+		return best.item;
+	}
+
+	/**
+	 * Find an open node by key.
+	 * @param key The key to look for.
+	 * @return The open node specified by a key or \c nullptr if not found.
+	 */
+	inline Titem *FindOpenNode(const Key &key)
+	{
+		const Slot &slot = this->slots[this->FindSlot(key)];
+		return slot.item != nullptr && slot.heap_pos < POS_DETACHED ? slot.item : nullptr;
+	}
+
+	/**
+	 * Find and remove an open node by key.
+	 * @param key The key to look for.
+	 * @return The open node specified by a key.
+	 */
+	inline Titem &PopOpenNode(const Key &key)
+	{
+		Slot &slot = this->slots[this->FindSlot(key)];
+		assert(slot.item != nullptr && slot.heap_pos < POS_DETACHED);
+
+		size_t pos = slot.heap_pos;
+		slot.heap_pos = POS_DETACHED;
+		this->RemoveFromQueue(pos);
+		return *slot.item;
+	}
+
+	/**
+	 * Insert the given item into the closed nodes set.
+	 * @param item The item to add.
+	 */
+	inline void InsertClosedNode(Titem &item)
+	{
+		uint32_t index = this->AddToIndex(item);
+		assert(this->slots[index].heap_pos == POS_DETACHED);
+		this->slots[index].heap_pos = POS_CLOSED;
+		this->closed_count++;
+	}
+
+	/**
+	 * Find a closed node by its key.
+	 * @param key The key to look for.
+	 * @return The closed node specified by a key or \c nullptr if not found.
+	 */
+	inline Titem *FindClosedNode(const Key &key)
+	{
+		const Slot &slot = this->slots[this->FindSlot(key)];
+		return slot.item != nullptr && slot.heap_pos == POS_CLOSED ? slot.item : nullptr;
+	}
+
+	/**
+	 * Get a particular item.
+	 * @param index The index of the item.
+	 * @return The item.
+	 */
+	inline Titem &ItemAt(int index)
+	{
+		return this->items[index];
+	}
+
+	/**
+	 * Helper for creating output of this array.
+	 * @param dmp The data to dump.
+	 */
+	template <class D>
+	void Dump(D &dmp) const
+	{
+		dmp.WriteStructT("data", &this->items);
+	}
+};
+
+#endif /* DENSE_NODELIST_HPP */
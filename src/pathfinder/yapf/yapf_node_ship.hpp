@@ -12,13 +12,13 @@
 
 #include "../../tile_type.h"
 #include "../../track_type.h"
-#include "nodelist.hpp"
+#include "dense_nodelist.hpp"
 #include "yapf_node.hpp"
 
 /** Yapf Node for ships */
 struct CYapfShipNode : CYapfNodeT<CYapfNodeKeyExitDir, CYapfShipNode> {
 };
 
-typedef NodeList<CYapfShipNode, 10, 12> CShipNodeList;
+typedef DenseNodeList<CYapfShipNode> CShipNodeList;
 
 #endif /* YAPF_NODE_SHIP_HPP */
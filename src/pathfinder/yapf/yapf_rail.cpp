@@ -16,6 +16,7 @@
 #include "yapf_destrail.hpp"
 #include "../../viewport_func.h"
 #include "../../newgrf_station.h"
+#include "../../depot_func.h"
 
 #include "../../safeguards.h"
 
@@ -200,7 +201,13 @@ public:
 		}
 
 		/* Don't bother if the target is reserved. */
-		if (!IsWaitingPositionFree(Yapf().GetVehicle(), this->res_dest_tile, this->res_dest_td)) return false;
+		if (!IsWaitingPositionFree(Yapf().GetVehicle(), this->res_dest_tile, this->res_dest_td)) {
+			if (target != nullptr) {
+				target->blocked_tile = this->res_dest_tile;
+				target->blocked_trackdir = this->res_dest_td;
+			}
+			return false;
+		}
 
 		this->signals_set_to_red.clear();
 		for (Node *node = this->res_dest_node; node->parent != nullptr; node = node->parent) {
@@ -209,6 +216,10 @@ public:
 				/* Reservation failed, undo. */
 				Node *fail_node = this->res_dest_node;
 				TileIndex stop_tile = this->res_fail_tile;
+				if (target != nullptr) {
+					target->blocked_tile = this->res_fail_tile;
+					target->blocked_trackdir = this->res_fail_td;
+				}
 				do {
 					/* If this is the node that failed, stop at the failed tile. */
 					this->res_fail_tile = fail_node == node ? stop_tile : INVALID_TILE;
@@ -454,7 +465,7 @@ public:
 
 	inline Trackdir ChooseRailTrack(const Train *v, TileIndex, DiagDirection, TrackBits, bool &path_found, bool reserve_track, PBSTileInfo *target, TileIndex *dest)
 	{
-		if (target != nullptr) target->tile = INVALID_TILE;
+		if (target != nullptr) *target = PBSTileInfo();
 		if (dest != nullptr) *dest = INVALID_TILE;
 
 		/* set origin and destination nodes */
@@ -675,6 +686,15 @@ FindDepotData YapfTrainFindNearestDepot(const Train *v, int max_penalty)
 	TileIndex last_tile = moving_back->tile;
 	Trackdir td_rev = ReverseTrackdir(moving_back->GetVehicleTrackdir());
 
+	if (max_penalty != 0) {
+		/* Every tile of a path costs at least a corner length, so skip the search when no depot is that close. */
+		uint max_distance = max_penalty / YAPF_TILE_CORNER_LENGTH + 1;
+		if (!IsCompanyDepotNearby(origin.tile, max_distance, TileType::Railway, v->owner) &&
+				!IsCompanyDepotNearby(last_tile, max_distance, TileType::Railway, v->owner)) {
+			return FindDepotData();
+		}
+	}
+
 	return _settings_game.pf.forbid_90_deg
 		? CYapfAnyDepotRailNo90::stFindNearestDepotTwoWay(v, origin.tile, origin.trackdir, last_tile, td_rev, max_penalty, YAPF_INFINITE_PENALTY)
 		: CYapfAnyDepotRail::stFindNearestDepotTwoWay(v, origin.tile, origin.trackdir, last_tile, td_rev, max_penalty, YAPF_INFINITE_PENALTY);
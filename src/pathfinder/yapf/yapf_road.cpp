@@ -11,6 +11,7 @@
 #include "yapf.hpp"
 #include "yapf_node_road.hpp"
 #include "../../roadstop_base.h"
+#include "../../depot_func.h"
 
 #include "../../safeguards.h"
 
@@ -471,5 +472,10 @@ FindDepotData YapfRoadVehicleFindNearestDepot(const RoadVehicle *v, int max_dist
 		return FindDepotData();
 	}
 
+	/* Every tile of a path costs at least a corner length, so skip the search when no depot is that close. */
+	if (max_distance != 0 && !IsCompanyDepotNearby(tile, max_distance / YAPF_TILE_CORNER_LENGTH + 1, TileType::Road, v->owner)) {
+		return FindDepotData();
+	}
+
 	return CYapfRoadAnyDepot::stFindNearestDepot(v, tile, trackdir, max_distance);
 }
@@ -28,6 +28,9 @@ struct PBSTileInfo {
 	Trackdir  trackdir;  ///< The reserved trackdir on the tile.
 	bool      okay;      ///< True if tile is a safe waiting position, false otherwise.
 
+	TileIndex blocked_tile = INVALID_TILE; ///< Tile with the reservation that prevented reserving the path, INVALID_TILE if unknown.
+	Trackdir  blocked_trackdir = Trackdir::Invalid; ///< The trackdir that could not be reserved on #blocked_tile.
+
 	/**
 	 * Create an empty PBSTileInfo.
 	 */
@@ -17,6 +17,7 @@
 #include "articulated_vehicles.h"
 #include "newgrf_sound.h"
 #include "pathfinder/yapf/yapf.h"
+#include "pathfinder/follow_track.hpp"
 #include "strings_func.h"
 #include "tunnelbridge_map.h"
 #include "script/api/script_event_types.hpp"
@@ -38,6 +39,7 @@
 #include "roadveh_cmd.h"
 #include "road_cmd.h"
 #include "newgrf_roadstop.h"
+#include "worker_pool.h"
 
 #include "table/strings.h"
 
@@ -988,6 +990,95 @@ static Trackdir RoadFindPathToDest(RoadVehicle *v, TileIndex tile, DiagDirection
 	return FilterRedSignal(best_track);
 }
 
+/** Number of tiles ahead of a road vehicle that are searched for a junction to plan the path for. */
+static const uint ROADVEH_PATH_PREFETCH_TILES = 4;
+
+/** Request to plan the path of a road vehicle from a junction it is approaching. */
+struct RoadVehPathRequest {
+	RoadVehicle *v; ///< The vehicle to find the path for.
+	TileIndex tile; ///< The junction tile the vehicle is going to enter.
+	DiagDirection enterdir; ///< Direction in which the vehicle enters the junction.
+	TrackdirBits trackdirs; ///< Trackdirs reachable on the junction.
+	Trackdir trackdir = Trackdir::Invalid; ///< [out] Trackdir to take on the junction.
+	bool path_found = false; ///< [out] Whether the pathfinder found a path.
+	RoadVehPathCache path{}; ///< [out] Path to follow after the junction.
+};
+
+/**
+ * Look for the next junction a road vehicle is going to enter, if it needs a path for it.
+ * @param v The road vehicle.
+ * @param[out] request The request to fill with the junction.
+ * @return True if the path of the vehicle should be planned for the found junction.
+ */
+static bool FindUpcomingRoadJunction(RoadVehicle *v, RoadVehPathRequest &request)
+{
+	if (!v->path.empty() || v->dest_tile == INVALID_TILE || v->reverse_ctr != 0) return false;
+	if (v->vehstatus.Any({VehState::Crashed, VehState::Stopped}) || v->state > RVSB_TRACKDIR_MASK) return false;
+
+	/* The path for the first junction is only looked for when the vehicle drives somewhat normally. */
+	Trackdir trackdir = static_cast<Trackdir>(v->state);
+	if (IsReversingRoadTrackdir(trackdir)) return false;
+
+	TileIndex tile = v->tile;
+	if (!GetTrackdirBitsForRoad(tile, GetRoadTramType(v->roadtype)).Test(trackdir)) return false;
+
+	CFollowTrackRoad follower{v};
+	for (uint i = 0; i < ROADVEH_PATH_PREFETCH_TILES; i++) {
+		if (!follower.Follow(tile, trackdir)) return false;
+
+		tile = follower.new_tile;
+		/* The destination tile itself is handled by RoadFindPathToDest. */
+		if (tile == v->dest_tile) return false;
+
+		if (follower.new_td_bits.Count() > 1) {
+			request.v = v;
+			request.tile = tile;
+			request.enterdir = follower.exitdir;
+			request.trackdirs = follower.new_td_bits;
+			return true;
+		}
+		trackdir = follower.new_td_bits.GetNthSetBit(0).value();
+	}
+	return false;
+}
+
+/**
+ * Plan the paths of road vehicles that approach a junction, before any of them moves this tick.
+ * As the map does not change while planning, the pathfinder calls are independent of each other
+ * and are run on the worker threads. The found paths are stored in the path cache of each vehicle,
+ * which is consumed by #RoadFindPathToDest when the vehicle reaches the junction. When the road
+ * layout changed in the meantime and the cached choice is no longer possible, the cache gets
+ * invalidated and the path is searched for again at that moment.
+ */
+void PrefetchRoadVehiclePaths()
+{
+	PerformanceAccumulator framerate(PerformanceElement::GameLoopRoadVehicles);
+
+	std::vector<RoadVehPathRequest> requests;
+	for (RoadVehicle *v : RoadVehicle::Iterate()) {
+		/* Spread the look ahead over the ticks; it is far enough to not miss a junction. */
+		if (!v->IsFrontEngine() || GB(v->tick_counter, 0, 2) != 0) continue;
+
+		RoadVehPathRequest request;
+		if (FindUpcomingRoadJunction(v, request)) requests.push_back(std::move(request));
+	}
+	if (requests.empty()) return;
+
+	RunOnWorkers(requests.size(), [&requests](size_t index) {
+		RoadVehPathRequest &request = requests[index];
+		request.trackdir = YapfRoadVehicleChooseTrack(request.v, request.tile, request.enterdir, request.trackdirs, request.path_found, request.path);
+	});
+
+	for (RoadVehPathRequest &request : requests) {
+		/* Lost vehicles keep searching when they reach the junction, so their state is handled there. */
+		if (!request.path_found) continue;
+
+		request.path.emplace_back(request.trackdir, request.tile);
+		request.v->path = std::move(request.path);
+		request.v->HandlePathfindingResult(true);
+	}
+}
+
 struct RoadDriveEntry {
 	uint8_t x, y;
 };
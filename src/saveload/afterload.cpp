@@ -573,6 +573,7 @@ bool AfterLoadGame()
 
 	RebuildTownKdtree();
 	RebuildStationKdtree();
+	RebuildDepotKdtree();
 	/* This needs to be done even before conversion, because some conversions will destroy objects
 	 * that otherwise won't exist in the tree. */
 	RebuildViewportKdtree();
@@ -3444,6 +3445,9 @@ bool AfterLoadGame()
 
 	CheckGroundVehiclesAtCorrectZ();
 
+	/* Tiles may have been converted to level crossings after the vehicles were positioned. */
+	RecountLevelCrossingOccupancy(INVALID_TILE);
+
 	/* Start the scripts. This MUST happen after everything else except
 	 * starting a new company. */
 	StartScripts();
@@ -3490,6 +3494,8 @@ void ReloadNewGRFData()
 	AfterLoadCompanyStats();
 	/* Check and update house and town values */
 	UpdateHousesAndTowns();
+	/* Animation speeds might have changed, so animate all tiles at the next tick. */
+	UnscheduleAnimatedTiles();
 	/* Delete news referring to no longer existing entities */
 	DeleteInvalidEngineNews();
 	/* Update livery selection windows */
@@ -12,6 +12,7 @@
 #include "saveload.h"
 #include "compat/animated_tile_sl_compat.h"
 
+#include "../animated_tile_func.h"
 #include "../tile_type.h"
 
 #include "../safeguards.h"
@@ -27,6 +28,7 @@ struct ANITChunkHandler : ChunkHandler {
 
 	void Save() const override
 	{
+		UnscheduleAnimatedTiles();
 		SlTableHeader(_animated_tile_desc);
 
 		SlSetArrayIndex(0);
@@ -45,8 +45,8 @@ struct PSACChunkHandler : ChunkHandler {
 		SlTableHeader(_storage_desc);
 
 		/* Write the industries */
+		BasePersistentStorageArray::DiscardTemporaryChanges();
 		for (PersistentStorage *ps : PersistentStorage::Iterate()) {
-			ps->ClearChanges();
 			SlSetArrayIndex(ps->index);
 			SlObject(ps, _storage_desc);
 		}
@@ -814,6 +814,8 @@ public:
 		 SLE_CONDVAR(Train, flags, VarTypes::U16, SaveLoadVersion::Yapp, SaveLoadVersion::MaxVersion),
 		 SLE_CONDVAR(Train, wait_counter, VarTypes::U16, SaveLoadVersion::SplitLoadWaitCounters, SaveLoadVersion::MaxVersion),
 		 SLE_CONDVAR(Train, gv_flags, VarTypes::U16, SaveLoadVersion::RvRealisticAcceleration, SaveLoadVersion::MaxVersion),
+		 SLE_CONDVAR(Train, blocked_tile, VarTypes::U32, SaveLoadVersion::TrainBlockedReservation, SaveLoadVersion::MaxVersion),
+		 SLE_CONDVAR(Train, blocked_trackdir, VarTypes::U8, SaveLoadVersion::TrainBlockedReservation, SaveLoadVersion::MaxVersion),
 	};
 	static inline const SaveLoadCompatTable compat_description = _vehicle_train_sl_compat;
 
@@ -28,13 +28,24 @@
 #include "video/video_driver.hpp"
 #include "smallmap_gui.h"
 #include "screenshot_type.h"
+#include "thread.h"
+#include "worker_pool.h"
 
 #include "table/strings.h"
 
+#include <atomic>
+
 #include "safeguards.h"
 
 static const std::string_view SCREENSHOT_NAME = "screenshot"; ///< Default filename of a saved screenshot.
 static const std::string_view HEIGHTMAP_NAME  = "heightmap";  ///< Default filename of a saved heightmap.
+static const std::string_view TILES_NAME      = "tiles";      ///< Default directory name of saved map tiles.
+
+static const int LARGE_WORLD_BLOCK_WIDTH = 4096; ///< Width of the blocks a large screenshot is drawn in; a multiple of the screen tiles of the viewport.
+static const size_t LARGE_WORLD_CHUNK_SIZE = 64 * 1024 * 1024; ///< Size in bytes of a chunk of lines of a large screenshot that is drawn at once.
+static const uint LARGE_WORLD_MAX_CHUNK_LINES = 256; ///< Maximum number of lines in a chunk of a large screenshot.
+static const int MAP_TILE_SIZE = 256; ///< Width and height of the images of map tiles.
+static const int MAP_TILES_PER_BLOCK = LARGE_WORLD_BLOCK_WIDTH / MAP_TILE_SIZE; ///< Number of map tiles that are drawn at once.
 
 std::string _screenshot_format_name;  ///< Extension of the current screenshot format.
 static std::string _screenshot_name;  ///< Filename of the screenshot file.
@@ -85,23 +96,25 @@ static void CurrentScreenCallback(void *buf, uint y, uint pitch, uint n)
 }
 
 /**
- * generate a large piece of the world
+ * Draw a part of a large screenshot.
  * @param vp Viewport area to draw
  * @param buf Videobuffer with same bitdepth as current blitter
- * @param y First line to render
+ * @param x First column to draw
+ * @param y First line to draw
+ * @param width Number of columns to draw
+ * @param height Number of lines to draw
  * @param pitch Pitch of the videobuffer
- * @param n Number of lines to render
  */
-static void LargeWorldCallback(Viewport &vp, void *buf, uint y, uint pitch, uint n)
+static void DrawLargeWorldArea(Viewport &vp, void *buf, int x, int y, int width, int height, uint pitch)
 {
 	DrawPixelInfo dpi{
 		.dst_ptr = buf,
-		.left = 0,
-		.top = static_cast<int>(y),
-		.width = vp.width,
-		.height = static_cast<int>(n),
+		.left = x,
+		.top = y,
+		.width = width,
+		.height = height,
 		.pitch = static_cast<int>(pitch),
-		.zoom = ZoomLevel::WorldScreenshot
+		.zoom = vp.zoom
 	};
 
 	/* We are no longer rendering to the screen */
@@ -110,28 +123,163 @@ static void LargeWorldCallback(Viewport &vp, void *buf, uint y, uint pitch, uint
 		.left = 0,
 		.top = 0,
 		.width = static_cast<int>(pitch),
-		.height = static_cast<int>(n),
+		.height = height,
 		.pitch = static_cast<int>(pitch),
 		.zoom = ZoomLevel::Min
 	});
 	AutoRestoreBackup disable_anim_backup(_screen_disable_anim, true);
 	AutoRestoreBackup dpi_backup(_cur_dpi, &dpi);
 
-	/* Render viewport in blocks of 1600 pixels width */
-	int left = 0;
-	while (vp.width - left != 0) {
-		int wx = std::min(vp.width - left, 1600);
+	/* Render viewport in blocks, each of which is split over the worker threads. */
+	int left = x;
+	while (x + width - left != 0) {
+		int wx = std::min(x + width - left, LARGE_WORLD_BLOCK_WIDTH);
 		left += wx;
 
 		ViewportDoDraw(vp,
 			ScaleByZoom(left - wx - vp.left, vp.zoom) + vp.virtual_left,
 			ScaleByZoom(y - vp.top, vp.zoom) + vp.virtual_top,
 			ScaleByZoom(left - vp.left, vp.zoom) + vp.virtual_left,
-			ScaleByZoom((y + n) - vp.top, vp.zoom) + vp.virtual_top
+			ScaleByZoom((y + height) - vp.top, vp.zoom) + vp.virtual_top
 		);
 	}
 }
 
+/**
+ * generate a large piece of the world
+ * @param vp Viewport area to draw
+ * @param buf Videobuffer with same bitdepth as current blitter
+ * @param y First line to render
+ * @param pitch Pitch of the videobuffer
+ * @param n Number of lines to render
+ */
+static void LargeWorldCallback(Viewport &vp, void *buf, uint y, uint pitch, uint n)
+{
+	DrawLargeWorldArea(vp, buf, 0, y, vp.width, n, pitch);
+}
+
+/**
+ * Renderer of large screenshots that draws chunks of many lines, one chunk ahead of the lines the screenshot provider asks for.
+ * The next chunk is drawn on a separate thread while the provider encodes the lines of the current one, so the
+ * encoding is hidden behind the drawing. At most two chunks are kept in memory.
+ */
+class LargeWorldRenderer {
+	/** Lines that have been drawn. */
+	struct Chunk {
+		std::vector<uint8_t> buffer; ///< Pixels of the lines.
+		uint first = 0; ///< First line in the buffer.
+		uint last = 0; ///< Line after the last line in the buffer.
+	};
+
+	Viewport &vp; ///< Viewport area to draw.
+	uint bpp; ///< Number of bytes per pixel.
+	uint chunk_lines = 0; ///< Number of lines per chunk; 0 till the provider asked for its first lines.
+	bool backwards = false; ///< Whether the provider asks for the lines from the bottom up.
+	Chunk current{}; ///< Chunk the provider is being served from.
+	Chunk ahead{}; ///< Chunk that is drawn next, possibly by #thread.
+	std::thread thread{}; ///< Thread drawing #ahead, if any.
+
+	/**
+	 * Draw lines into a chunk.
+	 * @param chunk The chunk to draw.
+	 * @param first First line to draw.
+	 * @param last Line after the last line to draw.
+	 */
+	void DrawChunk(Chunk &chunk, uint first, uint last)
+	{
+		chunk.buffer.resize(static_cast<size_t>(this->vp.width) * this->chunk_lines * this->bpp);
+		chunk.first = first;
+		chunk.last = last;
+		LargeWorldCallback(this->vp, chunk.buffer.data(), first, this->vp.width, last - first);
+	}
+
+	/**
+	 * Entry point of the thread drawing the next chunk.
+	 * @param renderer The renderer to draw for.
+	 */
+	static void DrawAheadThread(LargeWorldRenderer *renderer)
+	{
+		renderer->DrawChunk(renderer->ahead, renderer->ahead.first, renderer->ahead.last);
+	}
+
+	/** Start drawing the chunk after the current one, if there is any. */
+	void StartDrawAhead()
+	{
+		uint height = this->vp.height;
+		if (this->backwards) {
+			if (this->current.first == 0) return;
+			this->ahead.first = this->current.first - std::min(this->current.first, this->chunk_lines);
+			this->ahead.last = this->current.first;
+		} else {
+			if (this->current.last == height) return;
+			this->ahead.first = this->current.last;
+			this->ahead.last = std::min(height, this->current.last + this->chunk_lines);
+		}
+
+		/* Drawing uses global state, so the draw thread owns it till it is joined again. */
+		if (!StartNewThread(&this->thread, "ottd:screenshot", &LargeWorldRenderer::DrawAheadThread, this)) {
+			this->DrawChunk(this->ahead, this->ahead.first, this->ahead.last);
+		}
+	}
+
+	/** Wait for the chunk that is drawn ahead. */
+	void JoinDrawAhead()
+	{
+		if (this->thread.joinable()) this->thread.join();
+	}
+
+public:
+	/**
+	 * Create the renderer.
+	 * @param vp Viewport area to draw.
+	 */
+	LargeWorldRenderer(Viewport &vp) : vp(vp), bpp(BlitterFactory::GetCurrentBlitter()->GetScreenDepth() / 8) {}
+
+	~LargeWorldRenderer()
+	{
+		this->JoinDrawAhead();
+	}
+
+	/**
+	 * Fill the buffer of the screenshot provider.
+	 * @param buf Videobuffer with same bitdepth as current blitter
+	 * @param y First line to render
+	 * @param pitch Pitch of the videobuffer
+	 * @param n Number of lines to render
+	 * @see ScreenshotCallback
+	 */
+	void operator()(void *buf, uint y, uint pitch, uint n)
+	{
+		if (this->chunk_lines == 0) {
+			size_t line_size = static_cast<size_t>(this->vp.width) * this->bpp;
+			this->chunk_lines = std::max<uint>(n, static_cast<uint>(Clamp<size_t>(LARGE_WORLD_CHUNK_SIZE / std::max<size_t>(line_size, 1), 1, LARGE_WORLD_MAX_CHUNK_LINES)));
+			/* Providers that do not start at the top, start at the bottom. */
+			this->backwards = y != 0;
+		}
+
+		if (pitch != static_cast<uint>(this->vp.width) || n > this->chunk_lines) {
+			this->JoinDrawAhead();
+			LargeWorldCallback(this->vp, buf, y, pitch, n);
+			return;
+		}
+
+		if (y < this->current.first || y + n > this->current.last) {
+			this->JoinDrawAhead();
+			if (y >= this->ahead.first && y + n <= this->ahead.last) {
+				std::swap(this->current, this->ahead);
+			} else if (this->backwards) {
+				this->DrawChunk(this->current, (y + n) - std::min(y + n, this->chunk_lines), y + n);
+			} else {
+				this->DrawChunk(this->current, y, std::min<uint>(this->vp.height, y + this->chunk_lines));
+			}
+			this->StartDrawAhead();
+		}
+
+		size_t line_size = static_cast<size_t>(pitch) * this->bpp;
+		std::copy_n(this->current.buffer.data() + (y - this->current.first) * line_size, n * line_size, static_cast<uint8_t *>(buf));
+	}
+};
+
 /**
  * Construct a pathname for a screenshot file.
  * @param default_fn Default filename.
@@ -288,13 +436,70 @@ static bool MakeLargeWorldScreenshot(ScreenshotType t, uint32_t width = 0, uint3
 	if (provider == nullptr) return false;
 
 	Viewport vp = SetupScreenshotViewport(t, width, height);
+	LargeWorldRenderer renderer(vp);
 
 	return provider->MakeImage(MakeScreenshotName(SCREENSHOT_NAME, provider->GetName()),
 			[&](void *buf, uint y, uint pitch, uint n) {
-				LargeWorldCallback(vp, buf, y, pitch, n);
+				renderer(buf, y, pitch, n);
 			}, vp.width, vp.height, BlitterFactory::GetCurrentBlitter()->GetScreenDepth(), _cur_palette.palette);
 }
 
+/**
+ * Make images of square tiles of the whole map for each zoom level, for use in a web map viewer.
+ * The images are stored as <tt>&lt;zoom&gt;/&lt;x&gt;/&lt;y&gt;</tt> in a directory, where zoom level 0 is the most zoomed out one.
+ * A row of tiles is drawn in blocks, after which the images of the block are encoded on the worker threads.
+ * @return true on success
+ */
+static bool MakeWorldTilesScreenshot()
+{
+	auto provider = GetScreenshotProvider();
+	if (provider == nullptr) return false;
+
+	if (_screenshot_name.empty()) _screenshot_name = TILES_NAME;
+	std::string directory = fmt::format("{}{}{}", FiosGetScreenshotDir(), _screenshot_name, PATHSEPCHAR);
+
+	int depth = BlitterFactory::GetCurrentBlitter()->GetScreenDepth();
+	uint bpp = depth / 8;
+	std::vector<uint8_t> buffer(static_cast<size_t>(LARGE_WORLD_BLOCK_WIDTH) * MAP_TILE_SIZE * bpp);
+
+	/* All zoom levels share the origin of the tiles, so the tiles of a level are exactly four tiles of the next one. */
+	ZoomLevel zoom_max = _settings_client.gui.zoom_max;
+	ZoomLevel zoom_min = std::max(_settings_client.gui.zoom_min, ZoomLevel::Normal);
+	for (int level = 0; level <= to_underlying(zoom_max) - to_underlying(zoom_min); level++) {
+		Viewport vp = SetupScreenshotViewport(SC_WORLD);
+		vp.zoom = static_cast<ZoomLevel>(to_underlying(zoom_max) - level);
+		vp.width = UnScaleByZoom(vp.virtual_width, vp.zoom);
+		vp.height = UnScaleByZoom(vp.virtual_height, vp.zoom);
+
+		int columns = CeilDiv(vp.width, MAP_TILE_SIZE);
+		int rows = CeilDiv(vp.height, MAP_TILE_SIZE);
+		for (int column = 0; column < columns; column++) FioCreateDirectory(fmt::format("{}{}{}{}", directory, level, PATHSEPCHAR, column));
+
+		for (int row = 0; row < rows; row++) {
+			for (int first_column = 0; first_column < columns; first_column += MAP_TILES_PER_BLOCK) {
+				int block_columns = std::min(columns - first_column, MAP_TILES_PER_BLOCK);
+				std::fill(buffer.begin(), buffer.end(), 0);
+				DrawLargeWorldArea(vp, buffer.data(), first_column * MAP_TILE_SIZE, row * MAP_TILE_SIZE, block_columns * MAP_TILE_SIZE, MAP_TILE_SIZE, LARGE_WORLD_BLOCK_WIDTH);
+
+				std::atomic<bool> success = true;
+				RunOnWorkers(block_columns, [&](size_t index) {
+					std::string name = fmt::format("{}{}{}{}{}{}.{}", directory, level, PATHSEPCHAR, first_column + index, PATHSEPCHAR, row, provider->GetName());
+					const uint8_t *tile = buffer.data() + index * MAP_TILE_SIZE * bpp;
+					bool written = provider->MakeImage(name, [&](void *buf, uint y, uint, uint n) {
+						for (uint line = 0; line < n; line++) {
+							std::copy_n(tile + (static_cast<size_t>(y + line) * LARGE_WORLD_BLOCK_WIDTH) * bpp, MAP_TILE_SIZE * bpp, static_cast<uint8_t *>(buf) + line * MAP_TILE_SIZE * bpp);
+						}
+					}, MAP_TILE_SIZE, MAP_TILE_SIZE, depth, _cur_palette.palette);
+					if (!written) success = false;
+				});
+				if (!success) return false;
+			}
+		}
+	}
+
+	return true;
+}
+
 /**
  * Callback for generating a heightmap. Supports 8bpp greyscale only.
  * @param buffer   Destination buffer.
@@ -424,6 +629,10 @@ static bool RealMakeScreenshot(ScreenshotType t, const std::string &name, uint32
 			ret = MakeLargeWorldScreenshot(t);
 			break;
 
+		case SC_WORLD_TILES:
+			ret = MakeWorldTilesScreenshot();
+			break;
+
 		case SC_HEIGHTMAP: {
 			auto provider = GetScreenshotProvider();
 			if (provider == nullptr) {
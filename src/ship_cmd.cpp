@@ -14,6 +14,7 @@
 #include "news_func.h"
 #include "company_func.h"
 #include "depot_base.h"
+#include "depot_kdtree.h"
 #include "station_base.h"
 #include "newgrf_engine.h"
 #include "pathfinder/yapf/yapf.h"
@@ -151,6 +152,16 @@ void Ship::GetImage(Direction direction, EngineImageType image_type, VehicleSpri
 
 static const Depot *FindClosestShipDepot(const Vehicle *v, uint max_distance)
 {
+	/* Step 0: collect the depots within range, so we don't search the water regions in vain. */
+	static std::vector<const Depot *> candidates;
+	candidates.clear();
+	ForAllDepotsRadius(v->tile, max_distance, [&](const Depot *depot) {
+		if (IsShipDepotTile(depot->xy) && IsTileOwner(depot->xy, v->owner) && DistanceSquare(depot->xy, v->tile) <= max_distance * max_distance) {
+			candidates.push_back(depot);
+		}
+	});
+	if (candidates.empty()) return nullptr;
+
 	const int max_region_distance = (max_distance / WATER_REGION_EDGE_LENGTH) + 1;
 
 	static std::unordered_set<int> visited_patch_hashes;
@@ -187,15 +198,13 @@ static const Depot *FindClosestShipDepot(const Vehicle *v, uint max_distance)
 	/* Step 2: Find the closest depot within the reachable Water Region Patches. */
 	const Depot *best_depot = nullptr;
 	uint best_dist_sq = std::numeric_limits<uint>::max();
-	for (const Depot *depot : Depot::Iterate()) {
-		const TileIndex tile = depot->xy;
-		if (IsShipDepotTile(tile) && IsTileOwner(tile, v->owner)) {
-			const uint dist_sq = DistanceSquare(tile, v->tile);
-			if (dist_sq < best_dist_sq && dist_sq <= max_distance * max_distance &&
-					visited_patch_hashes.count(CalculateWaterRegionPatchHash(GetWaterRegionPatchInfo(tile))) > 0) {
-				best_dist_sq = dist_sq;
-				best_depot = depot;
-			}
+	for (const Depot *depot : candidates) {
+		const uint dist_sq = DistanceSquare(depot->xy, v->tile);
+		/* Prefer the lowest index on equal distances, as the candidates are not in pool order. */
+		if (dist_sq > best_dist_sq || (dist_sq == best_dist_sq && depot->index > best_depot->index)) continue;
+		if (visited_patch_hashes.count(CalculateWaterRegionPatchHash(GetWaterRegionPatchInfo(depot->xy))) > 0) {
+			best_dist_sq = dist_sq;
+			best_depot = depot;
 		}
 	}
 
@@ -29,6 +29,7 @@
 #include "timer/timer.h"
 #include "timer/timer_window.h"
 #include "smallmap_gui.h"
+#include "worker_pool.h"
 #include "core/enum_type.hpp"
 
 #include "widgets/smallmap_widget.h"
@@ -184,6 +185,39 @@ static bool _smallmap_industry_highlight_state;
 /** For connecting company ID to position in owner list (small map legend) */
 static TypedIndexContainer<std::array<uint32_t, MAX_COMPANIES>, CompanyID> _company_to_list_pos;
 
+/**
+ * Colours of the individual tiles in the current smallmap mode.
+ * Drawing picks the most important tile of each group from here, so only tiles that changed
+ * since the last time they were drawn have to be looked at again.
+ */
+struct SmallMapTileCache {
+	static constexpr uint8_t STALE = 0xFF; ///< Importance of a tile whose colour has to be determined again.
+	static constexpr uint8_t LIVE = 0xFE; ///< Importance of a highlightable industry tile, whose colour depends on the blinking state.
+	static constexpr uint REFRESH_BANDS = 8; ///< Number of refresh intervals after which every tile has been determined again.
+
+	std::vector<uint32_t> colours; ///< Colour of each tile; for #LIVE tiles the colour when the industry is hidden.
+	std::vector<uint8_t> importance; ///< Importance of the effective tile type of each tile, or #STALE or #LIVE.
+	uint refresh_row = 0; ///< First row of the next band of rows to refresh.
+};
+
+/** Colours of the tiles in the current smallmap mode; empty while no smallmap is open. */
+static SmallMapTileCache _smallmap_tile_cache;
+
+/** Let the smallmap determine the colour of all tiles again, e.g. because a legend changed. */
+static void InvalidateSmallMapTileCache()
+{
+	std::fill(_smallmap_tile_cache.importance.begin(), _smallmap_tile_cache.importance.end(), SmallMapTileCache::STALE);
+}
+
+/**
+ * Let the smallmap determine the colour of a tile again.
+ * @param tile The tile that changed.
+ */
+void InvalidateSmallMapTile(TileIndex tile)
+{
+	if (tile.base() < _smallmap_tile_cache.importance.size()) _smallmap_tile_cache.importance[tile.base()] = SmallMapTileCache::STALE;
+}
+
 /**
  * Fills an array for the industries legends.
  */
@@ -303,6 +337,8 @@ static SmallMapColourScheme _heightmap_schemes[] = {
  */
 void BuildLandLegend()
 {
+	InvalidateSmallMapTileCache();
+
 	/* The smallmap window has never been initialized, so no need to change the legend. */
 	if (_heightmap_schemes[0].height_colours.empty()) return;
 
@@ -354,6 +390,8 @@ void BuildLandLegend()
  */
 void BuildOwnerLegend()
 {
+	InvalidateSmallMapTileCache();
+
 	_legend_land_owners[1].colour = PixelColour{static_cast<uint8_t>(_heightmap_schemes[_settings_client.gui.smallmap_land_colour].default_colour)};
 
 	int i = NUM_NO_COMPANY_ENTRIES;
@@ -769,6 +807,7 @@ protected:
 
 	/** Update the whole map on a regular interval. */
 	const IntervalTimer<TimerWindow> refresh_interval = {std::chrono::milliseconds(930), [this](auto) {
+		RefreshTileCacheBand();
 		ForceRefresh();
 	}};
 
@@ -846,6 +885,7 @@ protected:
 			legend[click_pos].show_on_map = !legend[click_pos].show_on_map;
 		}
 
+		InvalidateSmallMapTileCache();
 		if (this->map_type == SmallMapType::Industries) this->BreakIndustryChainLink();
 	}
 
@@ -860,6 +900,7 @@ protected:
 		this->LowerWidget(WID_SM_CONTOUR + to_underlying(this->map_type));
 
 		this->SetupWidgetData();
+		InvalidateSmallMapTileCache();
 
 		if (map_type == SmallMapType::LinkStats) this->overlay->SetDirty();
 		if (map_type != SmallMapType::Industries) this->BreakIndustryChainLink();
@@ -1108,6 +1149,23 @@ protected:
 		int x = - dx - 4;
 		int y = 0;
 
+		SmallMapTileCache &cache = _smallmap_tile_cache;
+		if (cache.importance.size() != Map::Size()) {
+			cache.colours.assign(Map::Size(), 0);
+			cache.importance.assign(Map::Size(), SmallMapTileCache::STALE);
+		}
+
+		/** Position of a column of the small map. */
+		struct Column {
+			void *dst; ///< Pointer to the first pixel of the column.
+			int tile_x; ///< X coordinate of the first tile in the column.
+			int tile_y; ///< Y coordinate of the first tile in the column.
+			int reps; ///< Number of lines to draw.
+			int start_pos; ///< Position of first pixel to draw.
+			int end_pos; ///< Position of last pixel to draw (exclusive).
+		};
+		std::vector<Column> columns;
+
 		for (;;) {
 			/* Distance from left edge */
 			if (x >= -3) {
@@ -1115,9 +1173,7 @@ protected:
 
 				int end_pos = std::min(dpi->width, x + 4);
 				int reps = (dpi->height - y + 1) / 2; // Number of lines.
-				if (reps > 0) {
-					this->DrawSmallMapColumn(ptr, tile_x, tile_y, dpi->pitch * 2, reps, x, end_pos, blitter);
-				}
+				if (reps > 0) columns.emplace_back(ptr, tile_x, tile_y, reps, x, end_pos);
 			}
 
 			if (y == 0) {
@@ -1133,6 +1189,16 @@ protected:
 			x += 2;
 		}
 
+		/* Each column shows its own diagonal of tiles and its own pixels, so columns can be drawn in parallel. */
+		const size_t batch = std::max<size_t>(1, columns.size() / (GetWorkerCount() * 4));
+		RunOnWorkers(CeilDiv(columns.size(), batch), [&](size_t index) {
+			size_t end = std::min(columns.size(), (index + 1) * batch);
+			for (size_t i = index * batch; i < end; i++) {
+				const Column &c = columns[i];
+				this->DrawSmallMapColumn(c.dst, c.tile_x, c.tile_y, dpi->pitch * 2, c.reps, c.start_pos, c.end_pos, blitter);
+			}
+		});
+
 		/* Draw vehicles */
 		if (this->map_type == SmallMapType::Contour || this->map_type == SmallMapType::Vehicles) this->DrawVehicles(dpi, blitter);
 
@@ -1349,84 +1415,89 @@ protected:
 	}
 
 	/**
-	 * Decide which colours to show to the user for a group of tiles.
-	 * @param ta Tile area to investigate.
-	 * @return Colours to display.
+	 * Determine the colour of a single tile in the current mode, and store it in the tile cache.
+	 * @param ti The tile.
+	 * @return Importance of the tile, or #SmallMapTileCache::LIVE.
 	 */
-	uint32_t GetTileColours(const TileArea &ta) const
+	uint8_t UpdateTileColour(TileIndex ti) const
 	{
-		int importance = 0;
-		TileIndex tile = INVALID_TILE; // Position of the most important tile.
-		TileType et = TileType::Void;         // Effective tile type at that position.
-
-		for (TileIndex ti : ta) {
-			TileType ttype = GetTileType(ti);
+		TileType ttype = GetTileType(ti);
+		bool live = false;
 
-			switch (ttype) {
-				case TileType::TunnelBridge: {
-					TransportType tt = GetTunnelBridgeTransportType(ti);
+		switch (ttype) {
+			case TileType::TunnelBridge: {
+				TransportType tt = GetTunnelBridgeTransportType(ti);
 
-					switch (tt) {
-						case TransportType::Rail: ttype = TileType::Railway; break;
-						case TransportType::Road: ttype = TileType::Road; break;
-						default: ttype = TileType::Water; break;
-					}
-					break;
+				switch (tt) {
+					case TransportType::Rail: ttype = TileType::Railway; break;
+					case TransportType::Road: ttype = TileType::Road; break;
+					default: ttype = TileType::Water; break;
 				}
-
-				case TileType::Industry:
-					/* Special handling of industries while in "Industries" smallmap view. */
-					if (this->map_type == SmallMapType::Industries) {
-						/* If industry is allowed to be seen, use its colour on the map.
-						 * This has the highest priority above any value in _tiletype_importance. */
-						IndustryType type = Industry::GetByTile(ti)->type;
-						if (_legend_from_industries[_industry_to_list_pos[type]].show_on_map) {
-							if (type == _smallmap_industry_highlight) {
-								if (_smallmap_industry_highlight_state) return MKCOLOUR_XXXX(PC_WHITE);
-							} else {
-								return GetIndustrySpec(type)->map_colour.p * 0x01010101;
-							}
-						}
-						/* Otherwise make it disappear */
-						ttype = IsTileOnWater(ti) ? TileType::Water : TileType::Clear;
-					}
-					break;
-
-				default:
-					break;
+				break;
 			}
 
-			if (_tiletype_importance[ttype] > importance) {
-				importance = _tiletype_importance[ttype];
-				tile = ti;
-				et = ttype;
-			}
+			case TileType::Industry:
+				/* Special handling of industries while in "Industries" smallmap view. */
+				if (this->map_type == SmallMapType::Industries) {
+					/* If industry is allowed to be seen, its colour depends on the highlight, so
+					 * it is determined while drawing. The cached colour is the one when it blinks. */
+					IndustryType type = Industry::GetByTile(ti)->type;
+					live = _legend_from_industries[_industry_to_list_pos[type]].show_on_map;
+					/* Otherwise make it disappear */
+					ttype = IsTileOnWater(ti) ? TileType::Water : TileType::Clear;
+				}
+				break;
+
+			default:
+				break;
 		}
 
+		uint32_t colour;
 		switch (this->map_type) {
-			case SmallMapType::Contour:
-				return GetSmallMapContoursPixels(tile, et);
-
-			case SmallMapType::Vehicles:
-				return GetSmallMapVehiclesPixels(tile, et);
-
-			case SmallMapType::Industries:
-				return GetSmallMapIndustriesPixels(tile, et);
-
-			case SmallMapType::LinkStats:
-				return GetSmallMapLinkStatsPixels(tile, et);
+			case SmallMapType::Contour:    colour = GetSmallMapContoursPixels(ti, ttype); break;
+			case SmallMapType::Vehicles:   colour = GetSmallMapVehiclesPixels(ti, ttype); break;
+			case SmallMapType::Industries: colour = GetSmallMapIndustriesPixels(ti, ttype); break;
+			case SmallMapType::LinkStats:  colour = GetSmallMapLinkStatsPixels(ti, ttype); break;
+			case SmallMapType::Routes:     colour = GetSmallMapRoutesPixels(ti, ttype); break;
+			case SmallMapType::Vegetation: colour = GetSmallMapVegetationPixels(ti, ttype); break;
+			case SmallMapType::Owners:     colour = GetSmallMapOwnerPixels(ti, ttype, IncludeHeightmap::IfEnabled); break;
+			default: NOT_REACHED();
+		}
 
-			case SmallMapType::Routes:
-				return GetSmallMapRoutesPixels(tile, et);
+		_smallmap_tile_cache.colours[ti.base()] = colour;
+		return _smallmap_tile_cache.importance[ti.base()] = live ? SmallMapTileCache::LIVE : _tiletype_importance[ttype];
+	}
 
-			case SmallMapType::Vegetation:
-				return GetSmallMapVegetationPixels(tile, et);
+	/**
+	 * Decide which colours to show to the user for a group of tiles.
+	 * @param ta Tile area to investigate.
+	 * @return Colours to display.
+	 * @note Tiles in the area that are not in the tile cache are added to it, so calls for overlapping areas must not run at the same time.
+	 */
+	uint32_t GetTileColours(const TileArea &ta) const
+	{
+		uint8_t importance = 0;
+		uint32_t colour = 0; // Colour of the most important tile.
 
-			case SmallMapType::Owners:
-				return GetSmallMapOwnerPixels(tile, et, IncludeHeightmap::IfEnabled);
+		for (TileIndex ti : ta) {
+			uint8_t tile_importance = _smallmap_tile_cache.importance[ti.base()];
+			if (tile_importance == SmallMapTileCache::STALE) tile_importance = this->UpdateTileColour(ti);
+
+			if (tile_importance == SmallMapTileCache::LIVE) {
+				/* A visible industry has the highest priority above any value in _tiletype_importance. */
+				IndustryType type = Industry::GetByTile(ti)->type;
+				if (type != _smallmap_industry_highlight) return GetIndustrySpec(type)->map_colour.p * 0x01010101;
+				if (_smallmap_industry_highlight_state) return MKCOLOUR_XXXX(PC_WHITE);
+				tile_importance = _tiletype_importance[IsTileOnWater(ti) ? TileType::Water : TileType::Clear];
+			}
 
-			default: NOT_REACHED();
+			if (tile_importance > importance) {
+				importance = tile_importance;
+				colour = _smallmap_tile_cache.colours[ti.base()];
+			}
 		}
+
+		return colour;
 	}
 
 	/**
@@ -1474,6 +1545,22 @@ protected:
 		this->SetDirty();
 	}
 
+	/**
+	 * Let the next band of rows determine their colours again. Changes that do not mark their
+	 * tile dirty, e.g. of a company colour, end up on the map after a few refresh intervals.
+	 */
+	void RefreshTileCacheBand()
+	{
+		SmallMapTileCache &cache = _smallmap_tile_cache;
+		if (cache.importance.empty()) return;
+
+		uint rows = CeilDiv(Map::SizeY(), SmallMapTileCache::REFRESH_BANDS);
+		if (cache.refresh_row >= Map::SizeY()) cache.refresh_row = 0;
+		uint end_row = std::min(cache.refresh_row + rows, Map::SizeY());
+		std::fill(cache.importance.begin() + TileXY(0, cache.refresh_row).base(), cache.importance.begin() + TileXY(0, end_row).base(), SmallMapTileCache::STALE);
+		cache.refresh_row = end_row;
+	}
+
 	/** Force a full refresh of the map. */
 	void ForceRefresh()
 	{
@@ -1545,6 +1632,7 @@ public:
 	void Close([[maybe_unused]] int data) override
 	{
 		this->BreakIndustryChainLink();
+		_smallmap_tile_cache = {};
 		this->Window::Close();
 	}
 
@@ -1832,6 +1920,7 @@ public:
 					tbl->show_on_map = (widget == WID_SM_ENABLE_ALL);
 				}
 				if (this->map_type == SmallMapType::LinkStats) this->SetOverlayCargoMask();
+				InvalidateSmallMapTileCache();
 				this->SetDirty();
 				break;
 			}
@@ -1839,6 +1928,7 @@ public:
 			case WID_SM_SHOW_HEIGHT: // Enable/disable showing of heightmap.
 				_smallmap_show_heightmap = !_smallmap_show_heightmap;
 				this->SetWidgetLoweredState(WID_SM_SHOW_HEIGHT, _smallmap_show_heightmap);
+				InvalidateSmallMapTileCache();
 				this->SetDirty();
 				break;
 		}
@@ -1878,6 +1968,7 @@ public:
 
 			default: NOT_REACHED();
 		}
+		InvalidateSmallMapTileCache();
 		this->SetDirty();
 	}
 
@@ -19,6 +19,7 @@
 #include "video/video_driver.hpp"
 #include "spritecache.h"
 #include "spritecache_internal.h"
+#include "spritecache_disk.h"
 
 #include "table/sprites.h"
 #include "table/palette_convert.h"
@@ -31,7 +32,11 @@ uint _sprite_cache_size = 4;
 
 static std::vector<SpriteCache> _spritecache;
 static size_t _spritecache_bytes_used = 0;
-static uint32_t _sprite_lru_counter;
+static SpriteCacheStatistics _spritecache_stats;
+
+static constexpr SpriteID SPRITE_LRU_END = UINT32_MAX; ///< End of the LRU list of loaded sprites.
+static SpriteID _sprite_lru_head = SPRITE_LRU_END; ///< Most recently used loaded sprite.
+static SpriteID _sprite_lru_tail = SPRITE_LRU_END; ///< Least recently used loaded sprite.
 static std::vector<std::unique_ptr<SpriteFile>> _sprite_files;
 
 static inline SpriteCache *GetSpriteCache(uint index)
@@ -53,6 +58,54 @@ SpriteCache *AllocateSpriteCache(uint index)
 	return GetSpriteCache(index);
 }
 
+/**
+ * Check whether a sprite is in the LRU list of loaded sprites.
+ * @param id The sprite.
+ * @return True iff the sprite is in the list.
+ */
+static inline bool IsInSpriteLRU(SpriteID id)
+{
+	return GetSpriteCache(id)->lru_prev != SPRITE_LRU_END || _sprite_lru_head == id;
+}
+
+/**
+ * Remove a sprite from the LRU list of loaded sprites.
+ * @param id The sprite, which must be in the list.
+ */
+static void UnlinkSpriteLRU(SpriteID id)
+{
+	SpriteCache *sc = GetSpriteCache(id);
+	if (sc->lru_prev != SPRITE_LRU_END) {
+		GetSpriteCache(sc->lru_prev)->lru_next = sc->lru_next;
+	} else {
+		_sprite_lru_head = sc->lru_next;
+	}
+	if (sc->lru_next != SPRITE_LRU_END) {
+		GetSpriteCache(sc->lru_next)->lru_prev = sc->lru_prev;
+	} else {
+		_sprite_lru_tail = sc->lru_prev;
+	}
+	sc->lru_prev = SPRITE_LRU_END;
+	sc->lru_next = SPRITE_LRU_END;
+}
+
+/**
+ * Add a sprite to the front of the LRU list of loaded sprites.
+ * @param id The sprite, which must not be in the list.
+ */
+static void LinkSpriteLRU(SpriteID id)
+{
+	SpriteCache *sc = GetSpriteCache(id);
+	sc->lru_prev = SPRITE_LRU_END;
+	sc->lru_next = _sprite_lru_head;
+	if (_sprite_lru_head != SPRITE_LRU_END) {
+		GetSpriteCache(_sprite_lru_head)->lru_prev = id;
+	} else {
+		_sprite_lru_tail = id;
+	}
+	_sprite_lru_head = id;
+}
+
 /**
  * Get the cached SpriteFile given the name of the file.
  * @param filename The name of the file at the disk.
@@ -107,6 +160,17 @@ bool SkipSpriteData(SpriteFile &file, uint8_t type, uint16_t num)
 	if (type & 2) {
 		file.SkipBytes(num);
 	} else {
+		/* Compressed sprites have to be decoded to find their end, unless the file has been indexed. */
+		const SpriteFileIndex *index = file.GetIndex();
+		if (index != nullptr) {
+			size_t begin = file.GetPos();
+			auto it = std::ranges::lower_bound(index->compressed_sprites, begin, {}, &std::pair<size_t, size_t>::first);
+			if (it != std::end(index->compressed_sprites) && it->first == begin) {
+				file.SkipBytes(it->second - begin);
+				return true;
+			}
+		}
+
 		while (num > 0) {
 			int8_t i = file.ReadByte();
 			if (i >= 0) {
@@ -532,11 +596,6 @@ static void *ReadSprite(const SpriteCache *sc, SpriteID id, SpriteType sprite_ty
 	return encoder->Encode(sprite_type, sprite, allocator);
 }
 
-struct GrfSpriteOffset {
-	size_t file_pos = 0;
-	SpriteCacheCtrlFlags control_flags{};
-};
-
 /** Map from sprite numbers to position in the GRF file. */
 static std::map<uint32_t, GrfSpriteOffset> _grf_sprite_offsets;
 
@@ -550,6 +609,54 @@ size_t GetGRFSpriteOffset(uint32_t id)
 	return _grf_sprite_offsets.find(id) != _grf_sprite_offsets.end() ? _grf_sprite_offsets[id].file_pos : SIZE_MAX;
 }
 
+/**
+ * Read the positions of the sprites in the sprite section of a GRF.
+ * @param file The file to read from, positioned just after the offset of the sprite section.
+ * @param data_offset The offset of the sprite section, relative to the current position.
+ * @param[out] offsets The positions of the sprites.
+ */
+static void ReadGRFSpriteSection(SpriteFile &file, size_t data_offset, std::map<uint32_t, GrfSpriteOffset> &offsets)
+{
+	/* Seek to sprite section of the GRF. */
+	size_t old_pos = file.GetPos();
+	file.SeekTo(data_offset, SEEK_CUR);
+
+	GrfSpriteOffset offset{};
+
+	/* Loop over all sprite section entries and store the file
+	 * offset for each newly encountered ID. */
+	SpriteID id, prev_id = 0;
+	while ((id = file.ReadDword()) != 0) {
+		if (id != prev_id) {
+			offsets[prev_id] = offset;
+			offset.file_pos = file.GetPos() - 4;
+			offset.control_flags.Reset();
+		}
+		prev_id = id;
+		uint length = file.ReadDword();
+		if (length > 0) {
+			SpriteComponents colour{file.ReadByte()};
+			length--;
+			if (length > 0) {
+				uint8_t zoom = file.ReadByte();
+				length--;
+				if (colour.Any() && zoom == 0) { // ZoomLevel::Normal (normal zoom)
+					offset.control_flags.Set((colour != SpriteComponent::Palette) ? SpriteCacheCtrlFlag::AllowZoomMin1x32bpp : SpriteCacheCtrlFlag::AllowZoomMin1xPal);
+					offset.control_flags.Set((colour != SpriteComponent::Palette) ? SpriteCacheCtrlFlag::AllowZoomMin2x32bpp : SpriteCacheCtrlFlag::AllowZoomMin2xPal);
+				}
+				if (colour.Any() && zoom == 2) { // ZoomLevel::In2x (2x zoomed in)
+					offset.control_flags.Set((colour != SpriteComponent::Palette) ? SpriteCacheCtrlFlag::AllowZoomMin2x32bpp : SpriteCacheCtrlFlag::AllowZoomMin2xPal);
+				}
+			}
+		}
+		file.SkipBytes(length);
+	}
+	if (prev_id != 0) offsets[prev_id] = offset;
+
+	/* Continue processing the data section. */
+	file.SeekTo(old_pos, SEEK_SET);
+}
+
 /**
  * Parse the sprite section of GRFs.
  * @param file The file to read the sprite offsets for.
@@ -559,46 +666,60 @@ void ReadGRFSpriteOffsets(SpriteFile &file)
 	_grf_sprite_offsets.clear();
 
 	if (file.GetContainerVersion() >= 2) {
-		/* Seek to sprite section of the GRF. */
 		size_t data_offset = file.ReadDword();
-		size_t old_pos = file.GetPos();
-		file.SeekTo(data_offset, SEEK_CUR);
-
-		GrfSpriteOffset offset{};
-
-		/* Loop over all sprite section entries and store the file
-		 * offset for each newly encountered ID. */
-		SpriteID id, prev_id = 0;
-		while ((id = file.ReadDword()) != 0) {
-			if (id != prev_id) {
-				_grf_sprite_offsets[prev_id] = offset;
-				offset.file_pos = file.GetPos() - 4;
-				offset.control_flags.Reset();
-			}
-			prev_id = id;
-			uint length = file.ReadDword();
-			if (length > 0) {
-				SpriteComponents colour{file.ReadByte()};
-				length--;
-				if (length > 0) {
-					uint8_t zoom = file.ReadByte();
-					length--;
-					if (colour.Any() && zoom == 0) { // ZoomLevel::Normal (normal zoom)
-						offset.control_flags.Set((colour != SpriteComponent::Palette) ? SpriteCacheCtrlFlag::AllowZoomMin1x32bpp : SpriteCacheCtrlFlag::AllowZoomMin1xPal);
-						offset.control_flags.Set((colour != SpriteComponent::Palette) ? SpriteCacheCtrlFlag::AllowZoomMin2x32bpp : SpriteCacheCtrlFlag::AllowZoomMin2xPal);
-					}
-					if (colour.Any() && zoom == 2) { // ZoomLevel::In2x (2x zoomed in)
-						offset.control_flags.Set((colour != SpriteComponent::Palette) ? SpriteCacheCtrlFlag::AllowZoomMin2x32bpp : SpriteCacheCtrlFlag::AllowZoomMin2xPal);
-					}
-				}
-			}
-			file.SkipBytes(length);
+
+		const SpriteFileIndex *index = file.GetIndex();
+		if (index != nullptr) {
+			_grf_sprite_offsets = index->sprite_offsets;
+		} else {
+			ReadGRFSpriteSection(file, data_offset, _grf_sprite_offsets);
 		}
-		if (prev_id != 0) _grf_sprite_offsets[prev_id] = offset;
+	}
+}
+
+/**
+ * Build the index of a sprite file, by walking its sprite stream the way the loading stages of a NewGRF do.
+ * Only \a file is used, so different files can be indexed concurrently.
+ * @param file The file to index, just opened.
+ * @return The index.
+ */
+std::unique_ptr<SpriteFileIndex> BuildSpriteFileIndex(SpriteFile &file)
+{
+	auto index = std::make_unique<SpriteFileIndex>();
+
+	uint8_t container_version = file.GetContainerVersion();
+	if (container_version == 0) return index;
 
-		/* Continue processing the data section. */
-		file.SeekTo(old_pos, SEEK_SET);
+	if (container_version >= 2) {
+		size_t data_offset = file.ReadDword();
+		ReadGRFSpriteSection(file, data_offset, index->sprite_offsets);
+
+		/* Unsupported compression; the stages will not read the sprite stream either. */
+		if (file.ReadByte() != 0) return index;
 	}
+
+	while (!file.AtEndOfFile()) {
+		uint32_t num = container_version >= 2 ? file.ReadDword() : file.ReadWord();
+		if (num == 0) break;
+
+		uint8_t type = file.ReadByte();
+		if (type == 0xFF || (container_version >= 2 && type == 0xFD)) {
+			file.SkipBytes(num);
+			continue;
+		}
+		if (num < 8) break;
+
+		file.SkipBytes(7);
+		size_t begin = file.GetPos();
+		if ((type & 2) != 0) {
+			file.SkipBytes(num - 8);
+			continue;
+		}
+		if (!SkipSpriteData(file, type, num - 8)) break;
+		index->compressed_sprites.emplace_back(begin, file.GetPos());
+	}
+
+	return index;
 }
 
 
@@ -669,7 +790,6 @@ bool LoadNextSprite(SpriteID load_index, SpriteFile &file, uint file_sprite_id)
 	sc->file = &file;
 	sc->file_pos = file_pos;
 	sc->length = num;
-	sc->lru = 0;
 	sc->id = file_sprite_id;
 	sc->type = type;
 	sc->warned = false;
@@ -695,7 +815,7 @@ void DupSprite(SpriteID old_spr, SpriteID new_spr)
 
 /**
  * Delete entries from the sprite cache to remove the requested number of bytes.
- * Sprite data is removed in order of LRU values.
+ * Sprite data is removed starting with the least recently used sprite.
  * The total number of bytes removed may be larger than the number requested.
  * @param to_remove Requested number of bytes to remove.
  */
@@ -703,58 +823,15 @@ static void DeleteEntriesFromSpriteCache(size_t to_remove)
 {
 	const size_t initial_in_use = _spritecache_bytes_used;
 
-	struct SpriteInfo {
-		uint32_t lru;
-		SpriteID id;
-		size_t size;
-
-		bool operator<(const SpriteInfo &other) const
-		{
-			return this->lru < other.lru;
-		}
-	};
-
-	std::vector<SpriteInfo> candidates; // max heap, ordered by LRU
-	size_t candidate_bytes = 0;         // total bytes that would be released when clearing all sprites in candidates
-
-	auto push = [&](SpriteInfo info) {
-		candidates.push_back(info);
-		std::push_heap(candidates.begin(), candidates.end());
-		candidate_bytes += info.size;
-	};
-
-	auto pop = [&]() {
-		candidate_bytes -= candidates.front().size;
-		std::pop_heap(candidates.begin(), candidates.end());
-		candidates.pop_back();
-	};
-
-	SpriteID i = 0;
-	for (; i != static_cast<SpriteID>(_spritecache.size()) && candidate_bytes < to_remove; i++) {
-		const SpriteCache *sc = GetSpriteCache(i);
-		if (sc->ptr != nullptr) {
-			push({ sc->lru, i, sc->length });
-			if (candidate_bytes >= to_remove) break;
-		}
-	}
-	/* candidates now contains enough bytes to meet to_remove.
-	 * only sprites with LRU values <= the maximum (i.e. the top of the heap) need to be considered */
-	for (; i != static_cast<SpriteID>(_spritecache.size()); i++) {
-		const SpriteCache *sc = GetSpriteCache(i);
-		if (sc->ptr != nullptr && sc->lru <= candidates.front().lru) {
-			push({ sc->lru, i, sc->length });
-			while (!candidates.empty() && candidate_bytes - candidates.front().size >= to_remove) {
-				pop();
-			}
-		}
-	}
-
-	for (const auto &it : candidates) {
-		GetSpriteCache(it.id)->ClearSpriteData();
+	uint deleted = 0;
+	while (initial_in_use - _spritecache_bytes_used < to_remove && _sprite_lru_tail != SPRITE_LRU_END) {
+		GetSpriteCache(_sprite_lru_tail)->ClearSpriteData();
+		deleted++;
 	}
+	_spritecache_stats.evictions += deleted;
 
 	Debug(sprite, 3, "DeleteEntriesFromSpriteCache, deleted: {}, freed: {}, in use: {} --> {}, requested: {}",
-			candidates.size(), candidate_bytes, initial_in_use, _spritecache_bytes_used, to_remove);
+			deleted, initial_in_use - _spritecache_bytes_used, initial_in_use, _spritecache_bytes_used, to_remove);
 }
 
 void IncreaseSpriteLRU()
@@ -764,25 +841,21 @@ void IncreaseSpriteLRU()
 	if (_spritecache_bytes_used > target_size) {
 		DeleteEntriesFromSpriteCache(_spritecache_bytes_used - target_size + 512 * 1024);
 	}
+}
 
-	if (_sprite_lru_counter >= 0xC0000000) {
-		Debug(sprite, 3, "Fixing lru {}, inuse={}", _sprite_lru_counter, _spritecache_bytes_used);
-
-		for (SpriteCache &sc : _spritecache) {
-			if (sc.ptr != nullptr) {
-				if (sc.lru > 0x80000000) {
-					sc.lru -= 0x80000000;
-				} else {
-					sc.lru = 0;
-				}
-			}
-		}
-		_sprite_lru_counter -= 0x80000000;
-	}
+/**
+ * Get the counters of the sprite cache.
+ * @return The counters.
+ */
+const SpriteCacheStatistics &GetSpriteCacheStatistics()
+{
+	return _spritecache_stats;
 }
 
 void SpriteCache::ClearSpriteData()
 {
+	SpriteID id = static_cast<SpriteID>(this - _spritecache.data());
+	if (IsInSpriteLRU(id)) UnlinkSpriteLRU(id);
 	_spritecache_bytes_used -= this->length;
 	this->ptr.reset();
 }
@@ -869,20 +942,28 @@ void *GetRawSprite(SpriteID sprite, SpriteType type, SpriteAllocator *allocator,
 	if (allocator == nullptr && encoder == nullptr) {
 		/* Load sprite into/from spritecache */
 
-		/* Update LRU */
-		sc->lru = ++_sprite_lru_counter;
-
 		/* Load the sprite, if it is not loaded, yet */
 		if (sc->ptr == nullptr) {
+			_spritecache_stats.misses++;
 			UniquePtrSpriteAllocator cache_allocator;
 			if (sc->type == SpriteType::Recolour) {
 				ReadRecolourSprite(*sc->file, sc->file_pos, sc->length, cache_allocator);
-			} else {
-				ReadSprite(sc, sprite, type, cache_allocator, nullptr);
+			} else if (!ReadSpriteFromDiskCache(*sc, cache_allocator)) {
+				if (ReadSprite(sc, sprite, type, cache_allocator, nullptr) != nullptr) {
+					WriteSpriteToDiskCache(*sc, {cache_allocator.data.get(), cache_allocator.size});
+				}
 			}
 			sc->ptr = std::move(cache_allocator.data);
 			sc->length = static_cast<uint32_t>(cache_allocator.size);
 			_spritecache_bytes_used += sc->length;
+			LinkSpriteLRU(sprite);
+		} else {
+			_spritecache_stats.hits++;
+			/* Move it to the front of the LRU list. */
+			if (_sprite_lru_head != sprite) {
+				UnlinkSpriteLRU(sprite);
+				LinkSpriteLRU(sprite);
+			}
 		}
 
 		return static_cast<void *>(sc->ptr.get());
@@ -899,7 +980,11 @@ void GfxInitSpriteMem()
 	_spritecache.shrink_to_fit();
 
 	_sprite_files.clear();
+	CloseSpriteDiskCache();
 	_spritecache_bytes_used = 0;
+	_spritecache_stats = {};
+	_sprite_lru_head = SPRITE_LRU_END;
+	_sprite_lru_tail = SPRITE_LRU_END;
 }
 
 /**
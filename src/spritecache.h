@@ -15,6 +15,7 @@
 #include "spriteloader/spriteloader.hpp"
 
 extern uint _sprite_cache_size;
+extern bool _sprite_disk_cache;
 
 /** SpriteAllocator that allocates memory via a unique_ptr array. */
 class UniquePtrSpriteAllocator : public SpriteAllocator {
@@ -47,15 +48,24 @@ inline const uint8_t *GetNonSprite(SpriteID sprite, SpriteType type)
 	return (uint8_t*)GetRawSprite(sprite, type);
 }
 
+/** Counters of the sprite cache, since it was last initialised. */
+struct SpriteCacheStatistics {
+	uint64_t hits = 0; ///< Number of requested sprites that were in the cache.
+	uint64_t misses = 0; ///< Number of requested sprites that had to be loaded.
+	uint64_t evictions = 0; ///< Number of sprites removed to keep the cache within its size.
+};
+
 void GfxInitSpriteMem();
 void GfxClearSpriteCache();
 void GfxClearFontSpriteCache();
 void IncreaseSpriteLRU();
+const SpriteCacheStatistics &GetSpriteCacheStatistics();
 
 SpriteFile &OpenCachedSpriteFile(const std::string &filename, Subdirectory subdir, bool palette_remap);
 std::span<const std::unique_ptr<SpriteFile>> GetCachedSpriteFiles();
 
 void ReadGRFSpriteOffsets(SpriteFile &file);
+std::unique_ptr<SpriteFileIndex> BuildSpriteFileIndex(SpriteFile &file);
 size_t GetGRFSpriteOffset(uint32_t id);
 bool LoadNextSprite(SpriteID load_index, SpriteFile &file, uint file_sprite_id);
 bool SkipSpriteData(SpriteFile &file, uint8_t type, uint16_t num);
@@ -0,0 +1,357 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file spritecache_disk.cpp Cache of encoded sprites on disk, so they do not need to be decoded again on the next run. */
+
+#include "stdafx.h"
+#include "spritecache.h"
+#include "spritecache_disk.h"
+#include "blitter/factory.hpp"
+#include "debug.h"
+#include "fileio_func.h"
+#include "newgrf_scan_cache.h"
+#include "rev.h"
+#include "settings_type.h"
+#include "spriteloader/sprite_file_type.hpp"
+#include "zoom_func.h"
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#else
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+#include "safeguards.h"
+
+bool _sprite_disk_cache = false;
+
+/**
+ * Everything that determines the encoded data of a sprite.
+ * Stored as is in the cache file, so it must not have implicit padding.
+ */
+struct SpriteDiskCacheKey {
+	MD5Hash file_hash; ///< Hash that identifies the contents of the GRF file.
+	uint64_t file_size; ///< Size of the GRF file.
+	uint64_t file_pos; ///< Position of the sprite in the GRF file.
+	uint8_t type; ///< Type of the sprite.
+	uint8_t control_flags; ///< Control flags of the sprite.
+	uint8_t palette_remap; ///< Whether the palette of the GRF file gets remapped.
+	uint8_t sprite_zoom_min; ///< Highest resolution of the sprites that is used.
+	uint8_t zoom_min; ///< Minimum zoom level the blitter encodes.
+	uint8_t zoom_max; ///< Maximum zoom level the blitter encodes.
+	uint8_t font_zoom; ///< Zoom level of font sprites.
+	uint8_t padding; ///< Explicit padding, always zero.
+
+	bool operator==(const SpriteDiskCacheKey &other) const = default;
+};
+static_assert(sizeof(SpriteDiskCacheKey) == 40);
+
+/** Hash function for #SpriteDiskCacheKey. */
+struct SpriteDiskCacheKeyHash {
+	size_t operator()(const SpriteDiskCacheKey &key) const
+	{
+		uint64_t hash = key.file_pos * 0x9E3779B97F4A7C15ULL;
+		for (uint8_t b : key.file_hash) hash = (hash ^ b) * 0x100000001B3ULL;
+		return static_cast<size_t>(hash ^ (key.type | key.sprite_zoom_min << 8 | key.zoom_min << 16 | key.zoom_max << 24));
+	}
+};
+
+/** Location of the data of a sprite in the cache file. */
+struct SpriteDiskCacheEntry {
+	long offset; ///< Offset of the data in the file.
+	uint32_t length; ///< Length of the data.
+	uint64_t checksum; ///< Checksum of the data, to detect a damaged file.
+};
+
+static const uint32_t SPRITE_DISK_CACHE_MAGIC = 'O' | 'T' << 8 | 'S' << 16 | 'C' << 24; ///< Identification of the cache file; also catches a different byte order.
+static const uint32_t SPRITE_DISK_CACHE_VERSION = 3; ///< Version of the format of the cache file.
+static const long SPRITE_DISK_CACHE_MAX_SIZE = 1024L * 1024 * 1024; ///< Size above which the cache file is started over.
+
+/** The open cache file and its index. */
+struct SpriteDiskCache {
+	std::string blitter; ///< Name of the blitter the sprites are encoded for.
+	std::optional<FileHandle> file; ///< The cache file, or \c std::nullopt if it could not be opened.
+	long size = 0; ///< Size of the valid part of the file.
+	std::unordered_map<SpriteDiskCacheKey, SpriteDiskCacheEntry, SpriteDiskCacheKeyHash> index; ///< Sprites in the file.
+};
+
+static std::optional<SpriteDiskCache> _sprite_disk_cache_file;
+
+/**
+ * Compute the checksum of the data of a sprite in the cache file (64 bits FNV-1a).
+ * @param data The data.
+ * @return The checksum.
+ */
+static uint64_t GetSpriteDiskCacheChecksum(std::span<const std::byte> data)
+{
+	uint64_t checksum = 0xCBF29CE484222325ULL;
+	for (std::byte b : data) checksum = (checksum ^ std::to_integer<uint8_t>(b)) * 0x100000001B3ULL;
+	return checksum;
+}
+
+/**
+ * Take an exclusive lock on the cache file, so another instance of the game does not write to it at the same time.
+ * The lock is released when the file is closed.
+ * @param f The cache file.
+ * @return True iff the lock was taken; false when another instance holds it.
+ */
+static bool LockSpriteDiskCache(FILE *f)
+{
+#ifdef _WIN32
+	OVERLAPPED overlapped{};
+	return LockFileEx(reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(f))), LOCKFILE_EXCLUSIVE_LOCK | LOCKFILE_FAIL_IMMEDIATELY, 0, MAXDWORD, MAXDWORD, &overlapped) != 0;
+#else
+	return flock(fileno(f), LOCK_EX | LOCK_NB) == 0;
+#endif
+}
+
+/**
+ * Remove everything from the cache file.
+ * @param f The cache file.
+ * @return True iff the file is empty now.
+ */
+static bool TruncateSpriteDiskCache(FILE *f)
+{
+	if (fflush(f) != 0 || fseek(f, 0, SEEK_SET) != 0) return false;
+#ifdef _WIN32
+	return _chsize_s(_fileno(f), 0) == 0;
+#else
+	return ftruncate(fileno(f), 0) == 0;
+#endif
+}
+
+/**
+ * Start over with an empty cache file.
+ * The file is emptied instead of created anew, so the lock on it is kept.
+ * @param cache The cache with the opened and locked file.
+ */
+static void ResetSpriteDiskCache(SpriteDiskCache &cache)
+{
+	cache.index.clear();
+	if (!TruncateSpriteDiskCache(*cache.file)) {
+		cache.file.reset();
+		return;
+	}
+
+	/* The encoding of the blitters may change between versions of the game, so also store the revision. */
+	std::string_view revision = _openttd_revision;
+	const uint32_t header[] = {SPRITE_DISK_CACHE_MAGIC, SPRITE_DISK_CACHE_VERSION, static_cast<uint32_t>(revision.size())};
+	if (fwrite(header, sizeof(header), 1, *cache.file) != 1 || fwrite(revision.data(), revision.size(), 1, *cache.file) != 1) {
+		cache.file.reset();
+		return;
+	}
+	cache.size = static_cast<long>(sizeof(header) + revision.size());
+}
+
+/**
+ * Read the index of an existing cache file.
+ * @param cache The cache with the opened file.
+ * @return True iff the file is complete and written by this version of the game.
+ */
+static bool ReadSpriteDiskCacheIndex(SpriteDiskCache &cache)
+{
+	FILE *f = *cache.file;
+	if (fseek(f, 0, SEEK_END) != 0) return false;
+	long end = ftell(f);
+	if (end < 0 || end > SPRITE_DISK_CACHE_MAX_SIZE) return false;
+	if (fseek(f, 0, SEEK_SET) != 0) return false;
+
+	uint32_t header[3];
+	if (fread(header, sizeof(header), 1, f) != 1) return false;
+	if (header[0] != SPRITE_DISK_CACHE_MAGIC || header[1] != SPRITE_DISK_CACHE_VERSION) return false;
+
+	/* Sprites might be encoded differently by another version, so its sprites are not used. */
+	std::string_view revision = _openttd_revision;
+	std::string file_revision(revision.size(), '\0');
+	if (header[2] != revision.size() || fread(file_revision.data(), file_revision.size(), 1, f) != 1 || file_revision != revision) {
+		Debug(sprite, 1, "Ignoring sprite disk cache of another version");
+		return false;
+	}
+
+	long pos = static_cast<long>(sizeof(header) + revision.size());
+	while (pos < end) {
+		SpriteDiskCacheKey key;
+		uint32_t length;
+		uint64_t checksum;
+		if (fread(&key, sizeof(key), 1, f) != 1 || fread(&length, sizeof(length), 1, f) != 1 || fread(&checksum, sizeof(checksum), 1, f) != 1) return false;
+
+		pos += sizeof(key) + sizeof(length) + sizeof(checksum);
+		if (length < sizeof(Sprite) || length > end - pos) return false;
+		cache.index[key] = {pos, length, checksum};
+
+		pos += length;
+		if (fseek(f, pos, SEEK_SET) != 0) return false;
+	}
+	cache.size = pos;
+	return true;
+}
+
+/**
+ * Get the cache file for the current blitter, opening it when needed.
+ * @return The cache, or \c nullptr if it is disabled or could not be opened.
+ */
+static SpriteDiskCache *GetSpriteDiskCache()
+{
+	if (!_sprite_disk_cache) return nullptr;
+
+	std::string_view blitter = BlitterFactory::GetCurrentBlitter()->GetName();
+	if (_sprite_disk_cache_file.has_value() && _sprite_disk_cache_file->blitter == blitter) {
+		return _sprite_disk_cache_file->file.has_value() ? &*_sprite_disk_cache_file : nullptr;
+	}
+
+	/* Each blitter encodes sprites differently, so each gets its own file. */
+	SpriteDiskCache &cache = _sprite_disk_cache_file.emplace();
+	cache.blitter = blitter;
+	std::string filename = fmt::format("{}sprites-{}.cache", _personal_dir, blitter);
+
+	cache.file = FileHandle::Open(filename, "r+b");
+	if (!cache.file.has_value()) {
+		/* Create the file without truncating it, in case another instance just did the same. */
+		if (FileHandle::Open(filename, "ab").has_value()) cache.file = FileHandle::Open(filename, "r+b");
+		if (!cache.file.has_value()) {
+			Debug(sprite, 0, "Could not open sprite disk cache {}", filename);
+			return nullptr;
+		}
+	}
+
+	if (!LockSpriteDiskCache(*cache.file)) {
+		Debug(sprite, 1, "Sprite disk cache {} is in use by another instance; not using it", filename);
+		cache.file.reset();
+		return nullptr;
+	}
+
+	if (!ReadSpriteDiskCacheIndex(cache)) {
+		Debug(sprite, 1, "Starting new sprite disk cache {}", filename);
+		ResetSpriteDiskCache(cache);
+		if (!cache.file.has_value()) {
+			Debug(sprite, 0, "Could not write sprite disk cache {}", filename);
+			return nullptr;
+		}
+	}
+	Debug(sprite, 1, "Opened sprite disk cache {} with {} sprites", filename, cache.index.size());
+	return &cache;
+}
+
+/**
+ * Get the hash by which the disk cache identifies a GRF file. The MD5 hashes of base sets and
+ * NewGRFs do not cover the sprites of GRF container version 2, so instead use where the file is
+ * together with its size and modification time, like the NewGRF scan cache does.
+ * @param subdir The sub directory to find the file in.
+ * @param filename The name of the file.
+ * @return The hash, or an empty hash when the file is not directly on disk (e.g. in a tar).
+ */
+MD5Hash GetSpriteDiskCacheFileHash(Subdirectory subdir, std::string_view filename)
+{
+	std::string path = FioFindFullPath(subdir, filename);
+	if (path.empty()) return {};
+
+	std::optional<GRFScanStamp> stamp = GetGRFScanStamp(path);
+	if (!stamp.has_value()) return {};
+
+	Md5 checksum;
+	checksum.Append(path.data(), path.size());
+	checksum.Append(&stamp->size, sizeof(stamp->size));
+	checksum.Append(&stamp->mtime, sizeof(stamp->mtime));
+
+	MD5Hash hash;
+	checksum.Finish(hash);
+	return hash;
+}
+
+/**
+ * Get the key of a sprite in the sprite cache.
+ * @param sc The sprite.
+ * @param[out] key The key.
+ * @return True iff the sprite can be cached on disk.
+ */
+static bool GetSpriteDiskCacheKey(const SpriteCache &sc, SpriteDiskCacheKey &key)
+{
+	if (sc.file == nullptr || sc.type == SpriteType::Recolour) return false;
+	if (sc.file->GetContentHash() == MD5Hash{}) return false;
+
+	key = {};
+	key.file_hash = sc.file->GetContentHash();
+	key.file_size = sc.file->GetEndPos() - sc.file->GetStartPos();
+	key.file_pos = sc.file_pos;
+	key.type = to_underlying(sc.type);
+	key.control_flags = sc.control_flags.base();
+	key.palette_remap = sc.file->NeedsPaletteRemap();
+	key.sprite_zoom_min = to_underlying(_settings_client.gui.sprite_zoom_min);
+	key.zoom_min = to_underlying(_settings_client.gui.zoom_min);
+	key.zoom_max = to_underlying(_settings_client.gui.zoom_max);
+	key.font_zoom = sc.type == SpriteType::Font ? to_underlying(_font_zoom) : 0;
+	return true;
+}
+
+/**
+ * Read the encoded data of a sprite from the disk cache.
+ * @param sc The sprite to read.
+ * @param allocator The allocator to store the data with.
+ * @return True iff the sprite was found in the cache.
+ */
+bool ReadSpriteFromDiskCache(const SpriteCache &sc, SpriteAllocator &allocator)
+{
+	SpriteDiskCacheKey key;
+	if (!GetSpriteDiskCacheKey(sc, key)) return false;
+
+	SpriteDiskCache *cache = GetSpriteDiskCache();
+	if (cache == nullptr) return false;
+
+	auto it = cache->index.find(key);
+	if (it == cache->index.end()) return false;
+
+	FILE *f = *cache->file;
+	if (fseek(f, it->second.offset, SEEK_SET) != 0) return false;
+	std::byte *data = allocator.Allocate<std::byte>(it->second.length);
+	if (fread(data, it->second.length, 1, f) != 1 || GetSpriteDiskCacheChecksum({data, it->second.length}) != it->second.checksum) {
+		/* The file got damaged; do not try this entry again. */
+		Debug(sprite, 1, "Dropping damaged sprite from the sprite disk cache");
+		cache->index.erase(it);
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Add the encoded data of a sprite to the disk cache.
+ * @param sc The sprite.
+ * @param data The encoded data of the sprite.
+ */
+void WriteSpriteToDiskCache(const SpriteCache &sc, std::span<const std::byte> data)
+{
+	SpriteDiskCacheKey key;
+	if (!GetSpriteDiskCacheKey(sc, key)) return;
+
+	SpriteDiskCache *cache = GetSpriteDiskCache();
+	if (cache == nullptr || cache->index.contains(key)) return;
+
+	uint32_t length = static_cast<uint32_t>(data.size());
+	uint64_t checksum = GetSpriteDiskCacheChecksum(data);
+	long offset = cache->size + sizeof(key) + sizeof(length) + sizeof(checksum);
+	if (offset + static_cast<long>(length) > SPRITE_DISK_CACHE_MAX_SIZE) return;
+
+	FILE *f = *cache->file;
+	if (fseek(f, cache->size, SEEK_SET) != 0 ||
+			fwrite(&key, sizeof(key), 1, f) != 1 ||
+			fwrite(&length, sizeof(length), 1, f) != 1 ||
+			fwrite(&checksum, sizeof(checksum), 1, f) != 1 ||
+			fwrite(data.data(), data.size(), 1, f) != 1) {
+		Debug(sprite, 0, "Could not write to sprite disk cache; disabling it");
+		cache->file.reset();
+		return;
+	}
+
+	cache->index[key] = {offset, length, checksum};
+	cache->size = offset + length;
+}
+
+/** Close the disk cache, writing everything that is still buffered. */
+void CloseSpriteDiskCache()
+{
+	_sprite_disk_cache_file.reset();
+}
@@ -0,0 +1,23 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file spritecache_disk.h Cache of encoded sprites on disk, so they do not need to be decoded again on the next run. */
+
+#ifndef SPRITECACHE_DISK_H
+#define SPRITECACHE_DISK_H
+
+#include "fileio_type.h"
+#include "spritecache_internal.h"
+#include "spriteloader/spriteloader.hpp"
+#include "3rdparty/md5/md5.h"
+
+MD5Hash GetSpriteDiskCacheFileHash(Subdirectory subdir, std::string_view filename);
+bool ReadSpriteFromDiskCache(const SpriteCache &sc, SpriteAllocator &allocator);
+void WriteSpriteToDiskCache(const SpriteCache &sc, std::span<const std::byte> data);
+void CloseSpriteDiskCache();
+
+#endif /* SPRITECACHE_DISK_H */
@@ -25,7 +25,8 @@ struct SpriteCache {
 	SpriteFile *file = nullptr; ///< The file the sprite in this entry can be found in.
 	uint32_t length; ///< Length of sprite data.
 	uint32_t id = 0;
-	uint32_t lru = 0;
+	uint32_t lru_prev = UINT32_MAX; ///< Next more recently used sprite in the cache, or \c UINT32_MAX.
+	uint32_t lru_next = UINT32_MAX; ///< Next less recently used sprite in the cache, or \c UINT32_MAX.
 	SpriteType type = SpriteType::Invalid; ///< In some cases a single sprite is misused by two NewGRFs. Once as real sprite and once as recolour sprite. If the recolour sprite gets into the cache it might be drawn as real sprite which causes enormous trouble.
 	bool warned = false; ///< True iff the user has been warned about incorrect use of this sprite
 	SpriteCacheCtrlFlags control_flags{}; ///< Control flags, see SpriteCacheCtrlFlags
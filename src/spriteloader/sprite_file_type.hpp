@@ -11,6 +11,20 @@
 #define SPRITE_FILE_TYPE_HPP
 
 #include "../random_access_file_type.h"
+#include "../spritecache_type.h"
+#include "../3rdparty/md5/md5.h"
+
+/** Position of a sprite in the sprite section of a GRF. */
+struct GrfSpriteOffset {
+	size_t file_pos = 0; ///< Position of the first entry of the sprite.
+	SpriteCacheCtrlFlags control_flags{}; ///< Zoom levels the sprite is available in.
+};
+
+/** Positions in a sprite file that are found once, so the loading stages of a NewGRF do not need to find them again. */
+struct SpriteFileIndex {
+	std::vector<std::pair<size_t, size_t>> compressed_sprites; ///< Begin and end of the data of each compressed sprite in the sprite stream, sorted by begin.
+	std::map<uint32_t, GrfSpriteOffset> sprite_offsets; ///< Positions of the sprites in the sprite section, for container version 2.
+};
 
 /**
  * RandomAccessFile with some extra information specific for sprite files.
@@ -20,6 +34,8 @@ class SpriteFile : public RandomAccessFile {
 	bool palette_remap;     ///< Whether or not a remap of the palette is required for this file.
 	uint8_t container_version; ///< Container format of the sprite file.
 	size_t content_begin;   ///< The begin of the content of the sprite file, i.e. after the container metadata.
+	MD5Hash content_hash{}; ///< Hash that identifies the contents of the file, or all zeros when not known.
+	std::unique_ptr<SpriteFileIndex> index; ///< Index of the file, or \c nullptr if it has not been indexed.
 public:
 	SpriteFile(const std::string &filename, Subdirectory subdir, bool palette_remap);
 	SpriteFile(const SpriteFile&) = delete;
@@ -41,6 +57,30 @@ public:
 	 * Seek to the begin of the content, i.e. the position just after the container version has been determined.
 	 */
 	void SeekToBegin() { this->SeekTo(this->content_begin, SEEK_SET); }
+
+	/**
+	 * Get the hash that identifies the contents of the file in the sprite disk cache.
+	 * @return The hash, or all zeros when not known.
+	 */
+	const MD5Hash &GetContentHash() const { return this->content_hash; }
+
+	/**
+	 * Set the hash that identifies the contents of the file in the sprite disk cache.
+	 * @param hash The hash.
+	 */
+	void SetContentHash(const MD5Hash &hash) { this->content_hash = hash; }
+
+	/**
+	 * Get the index of the file.
+	 * @return The index, or \c nullptr if the file has not been indexed.
+	 */
+	const SpriteFileIndex *GetIndex() const { return this->index.get(); }
+
+	/**
+	 * Set the index of the file.
+	 * @param index The index, built from the same file.
+	 */
+	void SetIndex(std::unique_ptr<SpriteFileIndex> &&index) { this->index = std::move(index); }
 };
 
 #endif /* SPRITE_FILE_TYPE_HPP */
@@ -441,7 +441,11 @@ void Station::RemoveFromAllNearbyLists()
 		}
 	}
 
-	for (const TownID &townid : towns) { Town::Get(townid)->stations_near.erase(this); }
+	for (const TownID &townid : towns) {
+		Town *t = Town::Get(townid);
+		t->stations_near.erase(this);
+		t->InvalidateStationCatchments();
+	}
 	for (const IndustryID &industryid : industries) { Industry::Get(industryid)->stations_near.erase(this); }
 }
 
@@ -515,6 +519,7 @@ void Station::RecomputeCatchment(bool no_clear_nearby_lists)
 		if (IsTileType(tile, TileType::House)) {
 			Town *t = Town::GetByTile(tile);
 			t->stations_near.insert(this);
+			t->InvalidateStationCatchments();
 		}
 		if (IsTileType(tile, TileType::Industry)) {
 			Industry *i = Industry::GetByTile(tile);
@@ -536,7 +541,10 @@ void Station::RecomputeCatchment(bool no_clear_nearby_lists)
  */
 /* static */ void Station::RecomputeCatchmentForAll()
 {
-	for (Town *t : Town::Iterate()) { t->stations_near.clear(); }
+	for (Town *t : Town::Iterate()) {
+		t->stations_near.clear();
+		t->InvalidateStationCatchments();
+	}
 	for (Industry *i : Industry::Iterate()) { i->stations_near.clear(); }
 	for (Station *st : Station::Iterate()) { st->RecomputeCatchment(true); }
 }
@@ -3801,22 +3801,12 @@ static void TileLoop_Station(TileIndex tile)
 
 
 /** @copydoc AnimateTileProc */
-static void AnimateTile_Station(TileIndex tile)
+static uint AnimateTile_Station(TileIndex tile)
 {
-	if (HasStationRail(tile)) {
-		AnimateStationTile(tile);
-		return;
-	}
-
-	if (IsAirport(tile)) {
-		AnimateAirportTile(tile);
-		return;
-	}
-
-	if (IsAnyRoadStopTile(tile)) {
-		AnimateRoadStopTile(tile);
-		return;
-	}
+	if (HasStationRail(tile)) return AnimateStationTile(tile);
+	if (IsAirport(tile)) return AnimateAirportTile(tile);
+	if (IsAnyRoadStopTile(tile)) return AnimateRoadStopTile(tile);
+	return 1;
 }
 
 
@@ -4549,10 +4539,11 @@ void CcMoveStationName(Commands, const CommandCost &result, StationID station_id
 		SetViewportStationRect(st, false);
 	}
 
-static void AddNearbyStationsByCatchment(TileIndex tile, StationList &stations, StationList &nearby)
+static void AddNearbyStationsByCatchment(TileIndex tile, StationList &stations, Town *t)
 {
-	for (Station *st : nearby) {
-		if (st->TileIsInCatchment(tile)) stations.insert(st);
+	/* The bounds are checked first from the town's own table, so stations that are far away are not looked at. */
+	for (const TownStationCatchment &catchment : t->GetStationCatchments()) {
+		if (catchment.Contains(tile) && catchment.station->TileIsInCatchment(tile)) stations.insert(catchment.station);
 	}
 }
 
@@ -4566,7 +4557,7 @@ const StationList &StationFinder::GetStations()
 		if (IsTileType(this->tile, TileType::House)) {
 			/* Town nearby stations need to be filtered per tile. */
 			assert(this->w == 1 && this->h == 1);
-			AddNearbyStationsByCatchment(this->tile, this->stations, Town::GetByTile(this->tile)->stations_near);
+			AddNearbyStationsByCatchment(this->tile, this->stations, Town::GetByTile(this->tile));
 		} else {
 			ForAllStationsAroundTiles(*this, [this](Station *st, TileIndex) {
 				this->stations.insert(st);
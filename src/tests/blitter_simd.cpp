@@ -0,0 +1,228 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file blitter_simd.cpp Compare and benchmark the SIMD variants of the 32bpp blitters, without a video driver. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../blitter/factory.hpp"
+#include "../core/backup_type.hpp"
+#include "../core/format.hpp"
+#include "../gfx_func.h"
+#include "../spritecache.h"
+#include "test_helpers.h"
+
+#include "../safeguards.h"
+
+/** The 32bpp blitters without palette animation, slowest first. Blitters the build or the CPU does not have are skipped. */
+static const std::string_view _simd_blitters[] = {"32bpp-optimized", "32bpp-sse2", "32bpp-ssse3", "32bpp-sse4", "32bpp-avx2"};
+
+/** Modes to compare and measure, with their names for the report. */
+static const std::pair<BlitterMode, std::string_view> _simd_blitter_modes[] = {
+	{BlitterMode::Normal, "normal"},
+	{BlitterMode::ColourRemap, "remap"},
+	{BlitterMode::Transparent, "transparent"},
+	{BlitterMode::BlackRemap, "black"},
+};
+
+static constexpr uint SPRITE_WIDTH = 250; ///< Width of the test sprite; not a multiple of 8, so the tail loops are used too.
+static constexpr uint SPRITE_HEIGHT = 64; ///< Height of the test sprite.
+static constexpr uint DST_PITCH = 256; ///< Pitch of the destination buffer.
+
+/**
+ * Get a pseudo random byte, so each run draws the same pixels.
+ * @param random The random generator.
+ * @return The byte.
+ */
+static uint8_t NextSimdTestByte(TestRandom &random)
+{
+	return static_cast<uint8_t>(random.Next() >> 16);
+}
+
+/**
+ * Encode a test sprite with a mix of transparent, translucent and opaque pixels, some of them remappable.
+ * @param blitter The blitter to encode the sprite for.
+ * @param allocator The allocator that will own the encoded sprite.
+ * @return The encoded sprite.
+ */
+static const Sprite *EncodeSimdTestSprite(Blitter &blitter, UniquePtrSpriteAllocator &allocator)
+{
+	SpriteLoader::SpriteCollection sprites;
+	SpriteLoader::Sprite &sprite = sprites.Root();
+	sprite.width = SPRITE_WIDTH;
+	sprite.height = SPRITE_HEIGHT;
+	sprite.colours = {SpriteComponent::RGB, SpriteComponent::Alpha, SpriteComponent::Palette};
+	sprite.AllocateData(ZoomLevel::Min, SPRITE_WIDTH * SPRITE_HEIGHT);
+
+	TestRandom random(0x1234567);
+	for (uint i = 0; i < SPRITE_WIDTH * SPRITE_HEIGHT; i++) {
+		SpriteLoader::CommonPixel &pixel = sprite.data[i];
+		uint8_t kind = NextSimdTestByte(random) % 4;
+		pixel.r = NextSimdTestByte(random);
+		pixel.g = NextSimdTestByte(random);
+		pixel.b = NextSimdTestByte(random);
+		pixel.a = kind == 0 ? 0 : (kind == 1 ? NextSimdTestByte(random) : 0xFF);
+		pixel.m = (kind == 3 && NextSimdTestByte(random) % 2 == 0) ? NextSimdTestByte(random) : 0;
+	}
+
+	/* Fonts are only encoded at the normal zoom level, so the zoom settings do not matter. */
+	return blitter.Encode(SpriteType::Font, sprites, allocator);
+}
+
+/**
+ * Draw the test sprite over a pseudo random background.
+ * @param blitter The blitter to draw with.
+ * @param sprite The sprite, encoded by \a blitter.
+ * @param mode The mode to draw with.
+ * @param dst The destination buffer, filled with the background by the caller.
+ */
+static void DrawSimdTestSprite(Blitter &blitter, const Sprite *sprite, BlitterMode mode, std::vector<uint32_t> &dst)
+{
+	static std::array<uint8_t, 256> remap = []() {
+		std::array<uint8_t, 256> remap;
+		for (uint i = 0; i < remap.size(); i++) remap[i] = static_cast<uint8_t>(255 - i);
+		return remap;
+	}();
+
+	Blitter::BlitterParams bp{};
+	bp.sprite = sprite->data;
+	bp.remap = remap.data();
+	bp.width = bp.sprite_width = SPRITE_WIDTH;
+	bp.height = bp.sprite_height = SPRITE_HEIGHT;
+	bp.dst = dst.data();
+	bp.pitch = DST_PITCH;
+	blitter.Draw(&bp, mode, ZoomLevel::Min);
+}
+
+/**
+ * Get the background to draw the test sprite on.
+ * @return The pseudo random background.
+ */
+static std::vector<uint32_t> GetSimdTestBackground()
+{
+	std::vector<uint32_t> background(DST_PITCH * SPRITE_HEIGHT);
+	TestRandom random(0x1234567);
+	for (uint32_t &pixel : background) pixel = 0xFF000000 | NextSimdTestByte(random) << 16 | NextSimdTestByte(random) << 8 | NextSimdTestByte(random);
+	return background;
+}
+
+TEST_CASE("SIMD blitters draw the same as the SSE2 blitter")
+{
+	BlitterFactory *reference_factory = BlitterFactory::GetBlitterFactory("32bpp-sse2");
+	if (reference_factory == nullptr) return;
+
+	std::unique_ptr<Blitter> reference = reference_factory->CreateInstance();
+	UniquePtrSpriteAllocator reference_allocator;
+	const Sprite *reference_sprite = EncodeSimdTestSprite(*reference, reference_allocator);
+
+	for (std::string_view name : {"32bpp-ssse3", "32bpp-sse4", "32bpp-avx2"}) {
+		BlitterFactory *factory = BlitterFactory::GetBlitterFactory(name);
+		if (factory == nullptr) continue;
+
+		std::unique_ptr<Blitter> blitter = factory->CreateInstance();
+		UniquePtrSpriteAllocator allocator;
+		const Sprite *sprite = EncodeSimdTestSprite(*blitter, allocator);
+
+		for (BlitterMode mode : {BlitterMode::Normal, BlitterMode::Transparent, BlitterMode::BlackRemap}) {
+			std::vector<uint32_t> expected = GetSimdTestBackground();
+			DrawSimdTestSprite(*reference, reference_sprite, mode, expected);
+			std::vector<uint32_t> result = GetSimdTestBackground();
+			DrawSimdTestSprite(*blitter, sprite, mode, result);
+
+			/* When darkening, the SSE2 blitter also changes the alpha channel of the screen, which is not used. */
+			if (mode == BlitterMode::Transparent) {
+				for (uint32_t &pixel : expected) pixel |= 0xFF000000;
+				for (uint32_t &pixel : result) pixel |= 0xFF000000;
+			}
+
+			INFO(fmt::format("blitter {}, mode {}", name, to_underlying(mode)));
+			CHECK(result == expected);
+		}
+	}
+}
+
+/**
+ * Draw the test sprite with a blitter with palette animation, over a background that has an animation buffer too.
+ * @param blitter The blitter to draw with.
+ * @param mode The mode to draw with.
+ * @return The screen and animation buffer after drawing, as copied by the blitter.
+ */
+static std::vector<uint8_t> DrawSimdAnimTestSprite(Blitter &blitter, BlitterMode mode)
+{
+	UniquePtrSpriteAllocator allocator;
+	const Sprite *sprite = EncodeSimdTestSprite(blitter, allocator);
+
+	std::vector<uint32_t> screen(DST_PITCH * SPRITE_HEIGHT);
+	_screen.dst_ptr = screen.data();
+	_screen.width = DST_PITCH;
+	_screen.height = SPRITE_HEIGHT;
+	_screen.pitch = DST_PITCH;
+	blitter.PostResize();
+
+	/* Each line of the buffer has the pixels followed by the animation buffer; the latter has no animated colours. */
+	std::vector<uint32_t> background = GetSimdTestBackground();
+	std::vector<uint8_t> buffer(blitter.BufferSize(DST_PITCH, SPRITE_HEIGHT));
+	TestRandom random(0x7654321);
+	uint8_t *line = buffer.data();
+	for (uint y = 0; y < SPRITE_HEIGHT; y++) {
+		std::copy_n(reinterpret_cast<const uint8_t *>(&background[y * DST_PITCH]), DST_PITCH * sizeof(uint32_t), line);
+		line += DST_PITCH * sizeof(uint32_t);
+		for (uint x = 0; x < DST_PITCH; x++) {
+			uint16_t anim = NextSimdTestByte(random) % PALETTE_ANIM_START | NextSimdTestByte(random) << 8;
+			std::copy_n(reinterpret_cast<const uint8_t *>(&anim), sizeof(anim), line);
+			line += sizeof(anim);
+		}
+	}
+	blitter.CopyFromBuffer(screen.data(), buffer.data(), DST_PITCH, SPRITE_HEIGHT);
+
+	DrawSimdTestSprite(blitter, sprite, mode, screen);
+	blitter.CopyToBuffer(screen.data(), buffer.data(), DST_PITCH, SPRITE_HEIGHT);
+	return buffer;
+}
+
+TEST_CASE("AVX2 blitter with palette animation draws the same as the SSE4 one")
+{
+	BlitterFactory *reference_factory = BlitterFactory::GetBlitterFactory("32bpp-sse4-anim");
+	BlitterFactory *factory = BlitterFactory::GetBlitterFactory("32bpp-avx2-anim");
+	if (reference_factory == nullptr || factory == nullptr) return;
+
+	AutoRestoreBackup screen_backup(_screen);
+	std::unique_ptr<Blitter> reference = reference_factory->CreateInstance();
+	std::unique_ptr<Blitter> blitter = factory->CreateInstance();
+
+	for (const auto &[mode, mode_name] : _simd_blitter_modes) {
+		INFO(fmt::format("mode {}", mode_name));
+		CHECK(DrawSimdAnimTestSprite(*blitter, mode) == DrawSimdAnimTestSprite(*reference, mode));
+	}
+}
+
+TEST_CASE("SIMD blitters - benchmark", "[.benchmark]")
+{
+	static constexpr uint DRAW_COUNT = 2000;
+
+	for (std::string_view name : _simd_blitters) {
+		BlitterFactory *factory = BlitterFactory::GetBlitterFactory(name);
+		if (factory == nullptr) {
+			WARN(fmt::format("{} not available", name));
+			continue;
+		}
+
+		std::unique_ptr<Blitter> blitter = factory->CreateInstance();
+		UniquePtrSpriteAllocator allocator;
+		const Sprite *sprite = EncodeSimdTestSprite(*blitter, allocator);
+
+		for (const auto &[mode, mode_name] : _simd_blitter_modes) {
+			std::vector<uint32_t> dst = GetSimdTestBackground();
+			RunBenchmark(fmt::format("{:<16} {:<12}", name, mode_name), "pixels", [&]() {
+				for (uint i = 0; i < DRAW_COUNT; i++) DrawSimdTestSprite(*blitter, sprite, mode, dst);
+				return static_cast<uint64_t>(DRAW_COUNT) * SPRITE_WIDTH * SPRITE_HEIGHT;
+			});
+		}
+	}
+}
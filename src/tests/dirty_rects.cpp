@@ -0,0 +1,71 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file dirty_rects.cpp Test the coalescing of rectangles to redraw. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../gfx_func.h"
+#include "test_helpers.h"
+
+#include "../safeguards.h"
+
+/**
+ * Check whether every pixel of a rectangle is in one of the rectangles.
+ * @param rects The rectangles.
+ * @param r The rectangle that must be covered.
+ * @return True iff \a r is covered completely.
+ */
+static bool IsCovered(const std::vector<Rect> &rects, const Rect &r)
+{
+	for (int y = r.top; y <= r.bottom; y++) {
+		for (int x = r.left; x <= r.right; x++) {
+			if (std::ranges::none_of(rects, [x, y](const Rect &c) { return c.Contains({x, y}); })) return false;
+		}
+	}
+	return true;
+}
+
+TEST_CASE("CoalesceDirtyRects - close rectangles are merged")
+{
+	std::vector<Rect> rects = {{0, 0, 63, 7}, {64, 8, 127, 15}};
+	CoalesceDirtyRects(rects, 1024);
+
+	REQUIRE(rects.size() == 1);
+	CHECK(rects[0].left == 0);
+	CHECK(rects[0].top == 0);
+	CHECK(rects[0].right == 127);
+	CHECK(rects[0].bottom == 15);
+}
+
+TEST_CASE("CoalesceDirtyRects - distant rectangles stay apart")
+{
+	std::vector<Rect> rects = {{0, 0, 63, 7}, {512, 400, 575, 407}};
+	CoalesceDirtyRects(rects, 1024);
+
+	CHECK(rects.size() == 2);
+}
+
+TEST_CASE("CoalesceDirtyRects - everything stays covered")
+{
+	std::vector<Rect> original;
+	TestRandom random(1);
+	for (int i = 0; i < 200; i++) {
+		uint32_t value = random.Next();
+		int x = (value >> 8) % 30 * 64;
+		int y = (value >> 20) % 100 * 8;
+		original.push_back({x, y, x + 63, y + 7});
+	}
+
+	std::vector<Rect> rects = original;
+	CoalesceDirtyRects(rects, 8192);
+
+	CHECK(rects.size() < original.size());
+	for (const Rect &r : original) CHECK(IsCovered(rects, r));
+}
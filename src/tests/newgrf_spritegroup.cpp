@@ -0,0 +1,276 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file newgrf_spritegroup.cpp Test that compiled deterministic sprite groups resolve the same as the interpreted ones. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../core/format.hpp"
+#include "../newgrf_spritegroup.h"
+#include "test_helpers.h"
+
+#include "../safeguards.h"
+
+/** Scope with variables that depend on their number and parameter only. */
+struct TestScopeResolver : ScopeResolver {
+	TestScopeResolver(ResolverObject &ro) : ScopeResolver(ro) {}
+
+	uint32_t GetRandomBits() const override { return 0xA5; }
+	uint32_t GetRandomTriggers() const override { return 0x3; }
+
+	uint32_t GetVariable(uint8_t variable, uint32_t parameter, bool &available) const override
+	{
+		if (variable == 0x4F) {
+			available = false;
+			return UINT_MAX;
+		}
+		return variable * 0x01010101U + parameter * 0x1F;
+	}
+};
+
+/** Resolver object with the test scope for every scope. */
+struct TestResolverObject : ResolverObject {
+	TestScopeResolver scope;
+
+	TestResolverObject(bool use_fixed_scopes = false, uint32_t callback_param1 = 0x1234) : ResolverObject(nullptr, CBID_RANDOM_TRIGGER, callback_param1, 0xFEDC), scope(*this)
+	{
+		if (use_fixed_scopes) {
+			this->fixed_scopes[VarSpriteGroupScope::Self] = &this->scope;
+			this->fixed_scopes[VarSpriteGroupScope::Parent] = &this->scope;
+		}
+	}
+
+	ScopeResolver *GetScope(VarSpriteGroupScope, uint8_t) override { return &this->scope; }
+};
+
+/** Seed of the random generator, so each run makes the same sprite groups. */
+static constexpr uint32_t SPRITE_GROUP_TEST_SEED = 0x2468ACE;
+
+/** Variables the generated adjusts read; constant ones, special ones and ones of the scope. */
+static const uint8_t _test_variables[] = {0x0C, 0x10, 0x18, 0x1A, 0x1B, 0x1C, 0x1D, 0x40, 0x4F, 0x5F, 0x60, 0x7B, 0x7D, 0x7E, 0x7F};
+
+/**
+ * Make a deterministic sprite group with random adjusts.
+ * @param random The random generator.
+ * @param procedures The groups that may be used as procedure.
+ * @param error The group for unavailable variables.
+ * @return The sprite group.
+ */
+static DeterministicSpriteGroup *MakeTestGroup(TestRandom &random, const std::vector<const SpriteGroup *> &procedures, const SpriteGroup *error)
+{
+	DeterministicSpriteGroup *group = DeterministicSpriteGroup::Create();
+	group->size = static_cast<DeterministicSpriteGroupSize>(random.Next(3));
+
+	uint count = random.Next(6);
+	for (uint i = 0; i < count; i++) {
+		DeterministicSpriteGroupAdjust &adjust = group->adjusts.emplace_back();
+		adjust.operation = i == 0 ? DeterministicSpriteGroupAdjustOperation::Add : static_cast<DeterministicSpriteGroupAdjustOperation>(random.Next(to_underlying(DeterministicSpriteGroupAdjustOperation::Sar) + 1));
+		/* Mostly constant variables, so there is something to fold. */
+		adjust.variable = random.Next(2) == 0 ? 0x1A : _test_variables[random.Next(std::size(_test_variables))];
+		if (adjust.variable == 0x7E) {
+			adjust.subroutine = procedures[random.Next(static_cast<uint32_t>(procedures.size()))];
+		} else if (adjust.variable == 0x7B) {
+			/* Only global variables that do not need a NewGRF file, as the test resolver has none. */
+			adjust.parameter = _test_variables[random.Next(7)];
+		} else {
+			adjust.parameter = random.Next(0x20);
+		}
+		adjust.shift_num = random.Next(8);
+		adjust.type = static_cast<DeterministicSpriteGroupAdjustType>(random.Next(3));
+		adjust.and_mask = random.Next(2) == 0 ? 0xFF : 0xFFFF;
+		if (adjust.type != DeterministicSpriteGroupAdjustType::None) {
+			adjust.add_val = random.Next(16);
+			adjust.divmod_val = 1 + random.Next(7);
+		}
+	}
+
+	for (uint32_t low = 0; low < 0x200; low += 0x40) {
+		DeterministicSpriteGroupRange &range = group->ranges.emplace_back();
+		range.low = low;
+		range.high = low + random.Next(0x40);
+		range.result.calculated_result = random.Next(2) == 0;
+		if (!range.result.calculated_result) range.result.group = procedures[random.Next(static_cast<uint32_t>(procedures.size()))];
+	}
+	group->default_result.calculated_result = true;
+	group->error_group = error;
+	return group;
+}
+
+/**
+ * Make deterministic sprite groups with random adjusts, that use each other as procedure.
+ * @param random The random generator.
+ * @param count The number of groups to make.
+ * @return The sprite groups.
+ */
+static std::vector<DeterministicSpriteGroup *> MakeTestGroups(TestRandom &random, uint count)
+{
+	/* The groups, the error group and the callback result. */
+	REQUIRE(SpriteGroup::CanAllocateItem(count + 2));
+
+	const SpriteGroup *error = CallbackResultSpriteGroup::Create(0x77);
+	std::vector<const SpriteGroup *> procedures = {nullptr, error, CallbackResultSpriteGroup::Create(0x1234)};
+
+	std::vector<DeterministicSpriteGroup *> groups;
+	for (uint i = 0; i < count; i++) {
+		groups.push_back(MakeTestGroup(random, procedures, error));
+		procedures.push_back(groups.back());
+	}
+	return groups;
+}
+
+/**
+ * Make a sequence of callbacks, like the callbacks of a tile loop: a sprite group and the parameter to resolve it with.
+ * @param random The random generator.
+ * @param groups The sprite groups to pick from.
+ * @param count The length of the sequence.
+ * @return The sequence.
+ */
+static std::vector<std::pair<const SpriteGroup *, uint32_t>> MakeTestCallbackSequence(TestRandom &random, const std::vector<DeterministicSpriteGroup *> &groups, uint count)
+{
+	std::vector<std::pair<const SpriteGroup *, uint32_t>> sequence;
+	for (uint i = 0; i < count; i++) {
+		/* Callbacks come in runs on the same group, with a different parameter each time. */
+		const SpriteGroup *group = groups[random.Next(static_cast<uint32_t>(groups.size()))];
+		uint run = 1 + random.Next(8);
+		for (uint j = 0; j < run; j++) sequence.emplace_back(group, j);
+	}
+	return sequence;
+}
+
+TEST_CASE("Compiled sprite groups resolve like the interpreted ones")
+{
+	TestRandom random(SPRITE_GROUP_TEST_SEED);
+	std::vector<DeterministicSpriteGroup *> groups = MakeTestGroups(random, 500);
+
+	/* Resolve everything interpreted first, then compiled, the procedures before the groups that use them. */
+	std::vector<std::pair<ResolverResult, uint32_t>> expected;
+	for (DeterministicSpriteGroup *group : groups) {
+		TestResolverObject object;
+		object.root_spritegroup = group;
+		ResolverResult result = object.DoResolve();
+		expected.emplace_back(result, object.last_value);
+	}
+
+	uint constant = 0;
+	for (DeterministicSpriteGroup *group : groups) {
+		group->Compile();
+		if (group->constant) constant++;
+	}
+	CHECK(constant > 0);
+
+	for (size_t i = 0; i < groups.size(); i++) {
+		TestResolverObject object;
+		object.root_spritegroup = groups[i];
+		ResolverResult result = object.DoResolve();
+
+		INFO(fmt::format("group {}", i));
+		CHECK(result == expected[i].first);
+		CHECK(object.last_value == expected[i].second);
+	}
+
+	_spritegroup_pool.CleanPool();
+}
+
+TEST_CASE("Sprite groups that reach side effects through procedures or ranges are not pure")
+{
+	REQUIRE(SpriteGroup::CanAllocateItem(4));
+
+	DeterministicSpriteGroup *plain = DeterministicSpriteGroup::Create();
+	plain->default_result.calculated_result = true;
+	plain->Compile();
+	CHECK(plain->pure);
+
+	/* Resolving the randomized group reseeds, even though the adjusts do not store anything. */
+	DeterministicSpriteGroup *chain = DeterministicSpriteGroup::Create();
+	chain->default_result.group = RandomizedSpriteGroup::Create();
+	chain->Compile();
+	CHECK_FALSE(chain->pure);
+
+	DeterministicSpriteGroup *caller = DeterministicSpriteGroup::Create();
+	DeterministicSpriteGroupAdjust &adjust = caller->adjusts.emplace_back();
+	adjust.variable = 0x7E;
+	adjust.subroutine = chain;
+	adjust.and_mask = 0xFF;
+	caller->default_result.calculated_result = true;
+	caller->Compile();
+	CHECK_FALSE(caller->pure);
+
+	_spritegroup_pool.CleanPool();
+}
+
+TEST_CASE("Reused resolver objects with fixed scopes resolve like new ones")
+{
+	TestRandom random(SPRITE_GROUP_TEST_SEED);
+	std::vector<DeterministicSpriteGroup *> groups = MakeTestGroups(random, 200);
+	for (DeterministicSpriteGroup *group : groups) group->Compile();
+
+	TestResolverObject reused(true);
+	for (const auto &[group, param] : MakeTestCallbackSequence(random, groups, 500)) {
+		TestResolverObject object(false, param);
+		object.root_spritegroup = group;
+		ResolverResult expected = object.DoResolve();
+
+		reused.callback_param1 = param;
+		reused.root_spritegroup = group;
+		ResolverResult result = reused.DoResolve();
+
+		CHECK(result == expected);
+		CHECK(reused.last_value == object.last_value);
+	}
+
+	_spritegroup_pool.CleanPool();
+}
+
+TEST_CASE("Resolver objects - benchmark", "[.benchmark]")
+{
+	static constexpr uint REPEAT_COUNT = 200;
+
+	TestRandom random(SPRITE_GROUP_TEST_SEED);
+	std::vector<DeterministicSpriteGroup *> groups = MakeTestGroups(random, 200);
+	for (DeterministicSpriteGroup *group : groups) group->Compile();
+	std::vector<std::pair<const SpriteGroup *, uint32_t>> sequence = MakeTestCallbackSequence(random, groups, 1000);
+
+	/* The sum of the results makes sure the work is not optimised away, and must be the same for every way. */
+	std::vector<uint32_t> checksums;
+	auto measure = [&sequence, &checksums](std::string_view name, auto resolve) {
+		uint32_t &sum = checksums.emplace_back(0);
+		RunBenchmark(fmt::format("{:<28}", name), "callbacks", [&]() {
+			for (uint i = 0; i < REPEAT_COUNT; i++) {
+				for (const auto &[group, param] : sequence) sum += resolve(group, param);
+			}
+			return static_cast<uint64_t>(REPEAT_COUNT) * sequence.size();
+		});
+	};
+
+	measure("new object, virtual scopes", [](const SpriteGroup *group, uint32_t param) {
+		TestResolverObject object(false, param);
+		object.root_spritegroup = group;
+		object.DoResolve();
+		return object.last_value;
+	});
+
+	measure("new object, fixed scopes", [](const SpriteGroup *group, uint32_t param) {
+		TestResolverObject object(true, param);
+		object.root_spritegroup = group;
+		object.DoResolve();
+		return object.last_value;
+	});
+
+	TestResolverObject reused(true);
+	measure("reused object, fixed scopes", [&reused](const SpriteGroup *group, uint32_t param) {
+		reused.callback_param1 = param;
+		reused.root_spritegroup = group;
+		reused.DoResolve();
+		return reused.last_value;
+	});
+
+	CHECK(std::ranges::adjacent_find(checksums, std::not_equal_to{}) == checksums.end());
+
+	_spritegroup_pool.CleanPool();
+}
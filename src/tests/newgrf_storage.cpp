@@ -0,0 +1,66 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file newgrf_storage.cpp Test that temporary changes to persistent storage are reverted, and permanent ones kept. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../newgrf_storage.h"
+
+#include "../safeguards.h"
+
+TEST_CASE("Persistent storage reverts temporary changes")
+{
+	OldPersistentStorage storage;
+
+	/* Outside the game loop changes are temporary. */
+	storage.StoreValue(1, 10);
+	storage.StoreValue(1, 11);
+	storage.StoreValue(2, 20);
+	CHECK(storage.GetValue(1) == 11);
+	CHECK(storage.GetValue(2) == 20);
+
+	BasePersistentStorageArray::SwitchMode(PSM_ENTER_GAMELOOP);
+	CHECK(storage.GetValue(1) == 0);
+	CHECK(storage.GetValue(2) == 0);
+	CHECK(BasePersistentStorageArray::GetLastTickStats().reverted_writes == 3);
+
+	/* Inside the game loop changes are permanent... */
+	storage.StoreValue(1, 12);
+
+	/* ...except in command test mode. */
+	BasePersistentStorageArray::SwitchMode(PSM_ENTER_TESTMODE);
+	storage.StoreValue(1, 13);
+	storage.StoreValue(3, 30);
+	{
+		/* An array that is gone must not be reverted. */
+		OldPersistentStorage gone;
+		gone.StoreValue(0, 1);
+	}
+	BasePersistentStorageArray::SwitchMode(PSM_LEAVE_TESTMODE);
+	CHECK(storage.GetValue(1) == 12);
+	CHECK(storage.GetValue(3) == 0);
+
+	/* Writing the same value is no change, and out of range writes are ignored. */
+	storage.StoreValue(1, 12);
+	storage.StoreValue(16, 1);
+	CHECK(storage.GetValue(16) == 0);
+
+	BasePersistentStorageArray::SwitchMode(PSM_LEAVE_GAMELOOP);
+	BasePersistentStorageArray::SwitchMode(PSM_ENTER_GAMELOOP);
+	CHECK(storage.GetValue(1) == 12);
+
+	const PersistentStorageStats &stats = BasePersistentStorageArray::GetLastTickStats();
+	CHECK(stats.writes == 4);
+	CHECK(stats.temporary_writes == 3);
+	CHECK(stats.reverted_writes == 2);
+	CHECK(stats.reverted_arrays == 1);
+
+	BasePersistentStorageArray::SwitchMode(PSM_LEAVE_GAMELOOP);
+}
@@ -0,0 +1,65 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file test_helpers.h Pseudo random numbers and timing for the tests and benchmarks. */
+
+#ifndef TEST_HELPERS_H
+#define TEST_HELPERS_H
+
+#include <chrono>
+#include <iostream>
+
+#include "../core/format.hpp"
+
+/** Pseudo random generator, so each run of a test gets the same values. */
+struct TestRandom {
+	uint32_t seed; ///< The state of the generator.
+
+	/**
+	 * Create the generator.
+	 * @param seed The initial state.
+	 */
+	explicit TestRandom(uint32_t seed) : seed(seed) {}
+
+	/**
+	 * Get the next value. The low bits are not very random, so use the high ones.
+	 * @return The next state of the generator.
+	 */
+	uint32_t Next()
+	{
+		this->seed = this->seed * 1103515245 + 12345;
+		return this->seed;
+	}
+
+	/**
+	 * Get the next value in a range.
+	 * @param limit The end of the range.
+	 * @return The next value, from 0 up to \a limit exclusive.
+	 */
+	uint32_t Next(uint32_t limit)
+	{
+		return (this->Next() >> 8) % limit;
+	}
+};
+
+/**
+ * Run a benchmark and print how many items per second it handled.
+ * @param label Description of the benchmark, printed before the rate.
+ * @param unit Name of the items, e.g. "pixels".
+ * @param benchmark Function that runs the benchmark and returns the number of items it handled.
+ */
+template <typename F>
+void RunBenchmark(std::string_view label, std::string_view unit, F &&benchmark)
+{
+	auto start = std::chrono::steady_clock::now();
+	double items = static_cast<double>(benchmark());
+	std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+
+	std::cout << fmt::format("{} {:>14.0f} {}/s", label, items / duration.count(), unit) << std::endl;
+}
+
+#endif /* TEST_HELPERS_H */
@@ -0,0 +1,84 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file town_cmd.cpp Test that the stations near a town stay up to date when houses are built. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../command_func.h"
+#include "../newgrf_house.h"
+#include "../openttd.h"
+#include "../station_base.h"
+#include "../station_map.h"
+#include "../town.h"
+#include "../town_cmd.h"
+
+#include "../safeguards.h"
+
+/**
+ * Build a station with a single tile, and compute its catchment.
+ * @param tile The tile of the station.
+ * @return The station.
+ */
+static Station *BuildTestStation(TileIndex tile)
+{
+	Station *st = Station::Create(tile);
+	MakeStation(tile, OWNER_NONE, st->index, StationType::Rail, 0);
+	st->train_station = TileArea(tile, 1, 1);
+	st->rect.BeforeAddTile(tile, StationRect::ADD_FORCE);
+	st->RecomputeCatchment();
+	return st;
+}
+
+/**
+ * Check whether the catchment table of a town contains a station.
+ * @param t The town.
+ * @param st The station.
+ * @return True iff the station is in the table.
+ */
+static bool StationCatchmentsContain(Town *t, const Station *st)
+{
+	return std::ranges::any_of(t->GetStationCatchments(), [st](const TownStationCatchment &catchment) { return catchment.station == st; });
+}
+
+TEST_CASE("Houses built in the catchment of a station get the station in the table of their town")
+{
+	Map::Allocate(64, 64);
+	ResetHouses();
+	GameMode old_game_mode = _game_mode;
+	_game_mode = GameMode::Editor;
+
+	auto house = std::ranges::find_if(HouseSpec::Specs(), [](const HouseSpec &hs) { return hs.enabled && hs.building_flags.Test(BuildingFlag::Size1x1); });
+	REQUIRE(house != HouseSpec::Specs().end());
+	HouseID house_id = house->Index();
+
+	REQUIRE(Town::CanAllocateItem());
+	REQUIRE(Station::CanAllocateItem(2));
+	Town *t = Town::Create(TileXY(16, 16));
+	InitializeBuildingCounts();
+	RebuildTownKdtree();
+
+	/* A house near the first station makes its town build the table with that station. */
+	Station *first = BuildTestStation(TileXY(16, 16));
+	REQUIRE(Command<Commands::PlaceHouse>::Do({DoCommandFlag::Execute}, TileXY(17, 17), house_id, false, false).Succeeded());
+	CHECK(StationCatchmentsContain(t, first));
+
+	/* A house in the catchment of a second station must add it to the table that was already built. */
+	Station *second = BuildTestStation(TileXY(40, 40));
+	CHECK_FALSE(StationCatchmentsContain(t, second));
+	REQUIRE(Command<Commands::PlaceHouse>::Do({DoCommandFlag::Execute}, TileXY(41, 41), house_id, false, false).Succeeded());
+	CHECK(t->stations_near.contains(second));
+	CHECK(StationCatchmentsContain(t, first));
+	CHECK(StationCatchmentsContain(t, second));
+
+	_town_pool.CleanPool();
+	_station_pool.CleanPool();
+	RebuildTownKdtree();
+	_game_mode = old_game_mode;
+}
@@ -0,0 +1,227 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file yapf_nodelist.cpp Test and benchmark the node lists of YAPF with searches over generated grids. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../core/format.hpp"
+#include "../pathfinder/yapf/nodelist.hpp"
+#include "../pathfinder/yapf/dense_nodelist.hpp"
+#include "test_helpers.h"
+
+#include "../safeguards.h"
+
+/** Key of a grid node: the tile and the direction the tile was entered in. */
+struct GridKey {
+	uint32_t tile;
+	uint8_t dir;
+
+	inline int CalcHash() const
+	{
+		return static_cast<int>(this->dir | (this->tile << 3));
+	}
+
+	inline bool operator==(const GridKey &other) const = default;
+};
+
+/** Node of a search over a grid, with the same layout as the YAPF nodes. */
+struct GridNode {
+	using Key = GridKey;
+
+	Key key;
+	GridNode *hash_next;
+	GridNode *parent;
+	int cost;
+	int estimate;
+
+	inline GridNode *GetHashNext() { return this->hash_next; }
+	inline void SetHashNext(GridNode *next) { this->hash_next = next; }
+	inline const Key &GetKey() const { return this->key; }
+	inline int GetCost() const { return this->cost; }
+	inline int GetCostEstimate() const { return this->estimate; }
+	inline bool operator<(const GridNode &other) const { return this->estimate < other.estimate; }
+};
+
+/** Generated map to search over. */
+struct Grid {
+	static constexpr uint SIZE = 256; ///< Width and height of the grid.
+
+	std::vector<bool> passable; ///< Whether each tile can be entered.
+	bool diagonal; ///< Whether moves to the diagonal neighbours are allowed.
+	int turn_cost; ///< Extra cost of changing direction.
+
+	/**
+	 * Generate a grid.
+	 * @param spacing Distance between lines of passable tiles; 1 for an open area with random obstacles.
+	 * @param diagonal Whether moves to the diagonal neighbours are allowed.
+	 * @param turn_cost Extra cost of changing direction.
+	 */
+	Grid(uint spacing, bool diagonal, int turn_cost) : passable(SIZE * SIZE), diagonal(diagonal), turn_cost(turn_cost)
+	{
+		TestRandom random(0x1234567);
+
+		for (uint y = 0; y < SIZE; y++) {
+			for (uint x = 0; x < SIZE; x++) {
+				bool on_line = (x % spacing) == 0 || (y % spacing) == 0;
+				/* Lines get an occasional gap, open areas get some obstacles. */
+				this->passable[y * SIZE + x] = on_line && (random.Next() >> 16) % 16 != 0;
+			}
+		}
+	}
+
+	/** A rail network: long lines with few junctions. */
+	static Grid Rail() { return Grid(16, false, 40); }
+	/** A road network: a dense grid of streets. */
+	static Grid Road() { return Grid(4, false, 30); }
+	/** Open water with islands. */
+	static Grid Water() { return Grid(1, true, 10); }
+};
+
+/** Offsets of the neighbours, the first four are the straight ones. */
+static constexpr std::array<std::pair<int, int>, 8> _grid_offsets = {{{1, 0}, {0, 1}, {-1, 0}, {0, -1}, {1, 1}, {-1, 1}, {-1, -1}, {1, -1}}};
+
+/**
+ * Run an A-star search over a grid in the same way as #CYapfBaseT does.
+ * @tparam TNodeList The node list to use.
+ * @param grid The grid to search.
+ * @param from Start tile.
+ * @param to Destination tile.
+ * @param[out] closed_nodes Number of nodes that got closed.
+ * @return The cost of the best path, or -1 if there is no path.
+ */
+template <class TNodeList>
+static int SearchGrid(const Grid &grid, uint32_t from, uint32_t to, int &closed_nodes)
+{
+	TNodeList nodes;
+
+	auto estimate = [&grid, to](uint32_t tile) {
+		int dx = std::abs(static_cast<int>(tile % Grid::SIZE) - static_cast<int>(to % Grid::SIZE));
+		int dy = std::abs(static_cast<int>(tile / Grid::SIZE) - static_cast<int>(to / Grid::SIZE));
+		if (!grid.diagonal) return (dx + dy) * 100;
+		return std::max(dx, dy) * 100 + std::min(dx, dy) * 41;
+	};
+
+	GridNode &start = nodes.CreateNewNode();
+	start = GridNode{{from, 0}, nullptr, nullptr, 0, estimate(from)};
+	nodes.InsertOpenNode(start);
+
+	int result = -1;
+	for (;;) {
+		GridNode *best = nodes.GetBestOpenNode();
+		if (best == nullptr) break;
+		if (best->key.tile == to) {
+			result = best->cost;
+			break;
+		}
+
+		const int x = best->key.tile % Grid::SIZE;
+		const int y = best->key.tile / Grid::SIZE;
+		const uint8_t directions = grid.diagonal ? 8 : 4;
+		for (uint8_t dir = 0; dir < directions; dir++) {
+			const int nx = x + _grid_offsets[dir].first;
+			const int ny = y + _grid_offsets[dir].second;
+			if (nx < 0 || ny < 0 || nx >= static_cast<int>(Grid::SIZE) || ny >= static_cast<int>(Grid::SIZE)) continue;
+
+			const uint32_t tile = ny * Grid::SIZE + nx;
+			if (!grid.passable[tile]) continue;
+
+			GridNode &n = nodes.CreateNewNode();
+			n.key = {tile, dir};
+			n.hash_next = nullptr;
+			n.parent = best;
+			n.cost = best->cost + (dir < 4 ? 100 : 141) + (best->parent != nullptr && best->key.dir != dir ? grid.turn_cost : 0);
+			n.estimate = n.cost + estimate(tile);
+
+			GridNode *open_node = nodes.FindOpenNode(n.key);
+			if (open_node != nullptr) {
+				if (n.estimate < open_node->estimate) {
+					nodes.PopOpenNode(n.key);
+					*open_node = n;
+					nodes.InsertOpenNode(*open_node);
+				}
+				continue;
+			}
+			if (nodes.FindClosedNode(n.key) != nullptr) continue;
+			nodes.InsertOpenNode(n);
+		}
+
+		nodes.PopOpenNode(best->key);
+		nodes.InsertClosedNode(*best);
+	}
+
+	closed_nodes = nodes.ClosedCount();
+	return result;
+}
+
+/**
+ * Get start and destination tiles for the searches, evenly spread over the grid.
+ * @param grid The grid.
+ * @param count Number of pairs to generate.
+ * @return Start and destination pairs on passable tiles.
+ */
+static std::vector<std::pair<uint32_t, uint32_t>> GetSearchEndpoints(const Grid &grid, uint count)
+{
+	auto find_passable = [&grid](uint32_t tile) {
+		while (!grid.passable[tile]) tile = (tile + 1) % (Grid::SIZE * Grid::SIZE);
+		return tile;
+	};
+
+	std::vector<std::pair<uint32_t, uint32_t>> endpoints;
+	for (uint i = 0; i < count; i++) {
+		uint32_t from = (i * 7919 * 31) % (Grid::SIZE * Grid::SIZE);
+		uint32_t to = (i * 104729 + 12345) % (Grid::SIZE * Grid::SIZE);
+		endpoints.emplace_back(find_passable(from), find_passable(to));
+	}
+	return endpoints;
+}
+
+using HashNodeList = NodeList<GridNode, 8, 10>;
+
+TEST_CASE("YAPF node lists find equally good paths")
+{
+	for (const Grid &grid : {Grid::Rail(), Grid::Road(), Grid::Water()}) {
+		for (const auto &[from, to] : GetSearchEndpoints(grid, 8)) {
+			int closed;
+			int expected = SearchGrid<HashNodeList>(grid, from, to, closed);
+			CHECK(SearchGrid<DenseNodeList<GridNode, 2>>(grid, from, to, closed) == expected);
+			CHECK(SearchGrid<DenseNodeList<GridNode, 4>>(grid, from, to, closed) == expected);
+		}
+	}
+}
+
+/**
+ * Measure the speed of a node list.
+ * @tparam TNodeList The node list to measure.
+ * @param name Name of the node list in the report.
+ * @param grid_name Name of the grid in the report.
+ * @param grid The grid to search over.
+ */
+template <class TNodeList>
+static void BenchmarkNodeList(std::string_view name, std::string_view grid_name, const Grid &grid)
+{
+	RunBenchmark(fmt::format("{:<6} {:<16}", grid_name, name), "nodes", [&grid]() {
+		uint64_t total_nodes = 0;
+		for (const auto &[from, to] : GetSearchEndpoints(grid, 64)) {
+			int closed;
+			SearchGrid<TNodeList>(grid, from, to, closed);
+			total_nodes += closed;
+		}
+		return total_nodes;
+	});
+}
+
+TEST_CASE("YAPF node lists - benchmark", "[.benchmark]")
+{
+	for (const auto &[grid_name, grid] : {std::pair{"rail", Grid::Rail()}, std::pair{"road", Grid::Road()}, std::pair{"water", Grid::Water()}}) {
+		BenchmarkNodeList<HashNodeList>("hash/binary", grid_name, grid);
+		BenchmarkNodeList<DenseNodeList<GridNode, 2>>("dense/binary", grid_name, grid);
+		BenchmarkNodeList<DenseNodeList<GridNode, 4>>("dense/4-ary", grid_name, grid);
+	}
+}
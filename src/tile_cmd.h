@@ -139,9 +139,10 @@ using ClickTileProc = bool(TileIndex tile);
 /**
  * Tile callback function signature for animating a tile.
  * @param tile The tile to animate.
+ * @return The number of ticks, at least 1, until the tile needs animating again, assuming it does not change in the meantime.
  * @see AnimateTile
  */
-using AnimateTileProc = void(TileIndex tile);
+using AnimateTileProc = uint(TileIndex tile);
 
 /**
  * Tile callback function signature for running periodic tile updates.
@@ -271,11 +272,11 @@ inline bool MayAnimateTile(TileIndex tile)
 	return _tile_type_procs[GetTileType(tile)]->animate_tile_proc != nullptr;
 }
 
-inline void AnimateTile(TileIndex tile)
+inline uint AnimateTile(TileIndex tile)
 {
 	AnimateTileProc *proc = _tile_type_procs[GetTileType(tile)]->animate_tile_proc;
 	assert(proc != nullptr);
-	proc(tile);
+	return proc(tile);
 }
 
 inline bool ClickTile(TileIndex tile)
@@ -60,6 +60,25 @@ struct TownCache {
 	auto operator<=>(const TownCache &) const = default;
 };
 
+/** Bounds of the catchment of a station near a town, so the stations of a house can be found without looking at every nearby station. */
+struct TownStationCatchment {
+	Station *station; ///< The station.
+	uint left; ///< X coordinate of the west edge of the catchment.
+	uint top; ///< Y coordinate of the north edge of the catchment.
+	uint width; ///< Width of the catchment.
+	uint height; ///< Height of the catchment.
+
+	/**
+	 * Test whether a tile is within the bounds of the catchment.
+	 * @param tile The tile to test.
+	 * @return True iff the tile is within the bounds, the station might still not cover it.
+	 */
+	inline bool Contains(TileIndex tile) const
+	{
+		return IsInsideBS(TileX(tile), this->left, this->width) && IsInsideBS(TileY(tile), this->top, this->height);
+	}
+};
+
 /** Town data structure. */
 struct Town : TownPool::PoolItem<&_town_pool> {
 	TileIndex xy = INVALID_TILE; ///< town center tile
@@ -187,6 +206,7 @@ struct Town : TownPool::PoolItem<&_town_pool> {
 	}
 
 	StationList stations_near{}; ///< NOSAVE: List of nearby stations.
+	std::vector<TownStationCatchment> station_catchments{}; ///< NOSAVE: Catchment bounds of #stations_near, built by #GetStationCatchments; empty when it needs rebuilding.
 
 	uint16_t time_until_rebuild = 0; ///< time until we rebuild a house
 
@@ -231,6 +251,14 @@ struct Town : TownPool::PoolItem<&_town_pool> {
 
 	void UpdateVirtCoord();
 
+	const std::vector<TownStationCatchment> &GetStationCatchments();
+
+	/** Rebuild the catchment bounds of the nearby stations when they are needed next, as #stations_near or their catchments changed. */
+	inline void InvalidateStationCatchments()
+	{
+		this->station_catchments.clear();
+	}
+
 	inline const std::string &GetCachedName() const
 	{
 		if (!this->name.empty()) return this->name;
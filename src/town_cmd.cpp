@@ -316,14 +316,11 @@ static Foundation GetFoundation_Town(TileIndex tile, Slope tileh)
  * Only certain houses can be animated.
  * The newhouses animation supersedes regular ones.
  */
-static void AnimateTile_Town(TileIndex tile)
+static uint AnimateTile_Town(TileIndex tile)
 {
-	if (GetHouseType(tile) >= NEW_HOUSE_OFFSET) {
-		AnimateNewHouseTile(tile);
-		return;
-	}
+	if (GetHouseType(tile) >= NEW_HOUSE_OFFSET) return AnimateNewHouseTile(tile);
 
-	if (TimerGameTick::counter & 3) return;
+	if (TimerGameTick::counter & 3) return GetAnimationWait(4);
 
 	/* If the house is not one with a lift anymore, then stop this animating.
 	 * Not exactly sure when this happens, but probably when a house changes.
@@ -331,7 +328,7 @@ static void AnimateTile_Town(TileIndex tile)
 	 * That bug seems to have been here since day 1?? */
 	if (!HouseSpec::Get(GetHouseType(tile))->building_flags.Test(BuildingFlag::IsAnimated)) {
 		DeleteAnimatedTile(tile);
-		return;
+		return GetAnimationWait(4);
 	}
 
 	if (!LiftHasDestination(tile)) {
@@ -359,6 +356,7 @@ static void AnimateTile_Town(TileIndex tile)
 	}
 
 	MarkTileDirtyByTile(tile);
+	return GetAnimationWait(4);
 }
 
 /**
@@ -374,6 +372,23 @@ static bool IsCloseToTown(TileIndex tile, uint dist)
 	return DistanceManhattan(tile, t->xy) < dist;
 }
 
+/**
+ * Get the catchment bounds of the stations near this town, building them when needed.
+ * @return The bounds, in the order of #stations_near.
+ */
+const std::vector<TownStationCatchment> &Town::GetStationCatchments()
+{
+	if (this->station_catchments.empty() && !this->stations_near.empty()) {
+		this->station_catchments.reserve(this->stations_near.size());
+		for (Station *st : this->stations_near) {
+			const TileArea &area = st->catchment_tiles;
+			if (area.w == 0) continue;
+			this->station_catchments.push_back({st, TileX(area.tile), TileY(area.tile), area.w, area.h});
+		}
+	}
+	return this->station_catchments;
+}
+
 /** Resize the sign (label) of the town after it changes population. */
 void Town::UpdateVirtCoord()
 {
@@ -460,6 +475,7 @@ static void RemoveNearbyStations(Town *t, TileIndex tile, BuildingFlags flags)
 
 		if (covers_area && !st->CatchmentCoversTown(t->index)) {
 			it = t->stations_near.erase(it);
+			t->InvalidateStationCatchments();
 		} else {
 			++it;
 		}
@@ -604,8 +620,11 @@ static void TileLoop_Town(TileIndex tile)
 	StationFinder stations(TileArea(tile, 1, 1));
 
 	if (hs->callback_mask.Test(HouseCallbackMask::ProduceCargo)) {
+		/* The callback is asked for every cargo in turn, so only the parameter changes between the calls. */
+		HouseResolverObject object(house_id, tile, t, CBID_HOUSE_PRODUCE_CARGO, 0, r);
 		for (uint i = 0; i < 256; i++) {
-			uint16_t callback = GetHouseCallback(CBID_HOUSE_PRODUCE_CARGO, i, r, house_id, t, tile);
+			object.callback_param1 = i;
+			uint16_t callback = object.ResolveCallback({});
 
 			if (callback == CALLBACK_FAILED || callback == CALLBACK_HOUSEPRODCARGO_END) break;
 
@@ -724,8 +743,11 @@ static void AddProducedCargo_Town(TileIndex tile, CargoArray &produced)
 	Town *t = Town::GetByTile(tile);
 
 	if (hs->callback_mask.Test(HouseCallbackMask::ProduceCargo)) {
+		/* The callback is asked for every cargo in turn, so only the parameter changes between the calls. */
+		HouseResolverObject object(house_id, tile, t, CBID_HOUSE_PRODUCE_CARGO, 0, 0);
 		for (uint i = 0; i < 256; i++) {
-			uint16_t callback = GetHouseCallback(CBID_HOUSE_PRODUCE_CARGO, i, 0, house_id, t, tile);
+			object.callback_param1 = i;
+			uint16_t callback = object.ResolveCallback({});
 
 			if (callback == CALLBACK_FAILED || callback == CALLBACK_HOUSEPRODCARGO_END) break;
 
@@ -2538,6 +2560,7 @@ static void MakeTownHouse(TileIndex tile, Town *t, uint8_t counter, uint8_t stag
 
 	ForAllStationsAroundTiles(TileArea(tile, size.Any(BUILDING_2_TILES_X) ? 2 : 1, size.Any(BUILDING_2_TILES_Y) ? 2 : 1), [t](Station *st, TileIndex) {
 		t->stations_near.insert(st);
+		t->InvalidateStationCatchments();
 		return true;
 	});
 }
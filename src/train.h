@@ -69,6 +69,9 @@ int GetTrainStopLocation(StationID station_id, TileIndex tile, const Train *movi
 void GetTrainSpriteSize(EngineID engine, uint &width, uint &height, int &xoffs, int &yoffs, EngineImageType image_type);
 
 bool TrainOnCrossing(TileIndex tile);
+void UpdateLevelCrossingOccupancy(Vehicle *v, TileIndex tile);
+void RecountLevelCrossingOccupancy(TileIndex tile);
+void ResetLevelCrossingOccupancy();
 void NormalizeTrainVehInDepot(const Train *u);
 
 /** Variables that are cached to improve performance and such */
@@ -110,6 +113,9 @@ struct Train final : public GroundVehicle<Train, VehicleType::Train> {
 	TrackBits track{}; ///< On which track the train currently is.
 	TrainForceProceeding force_proceed{}; ///< How the train should behave when it encounters next obstacle.
 
+	TileIndex blocked_tile = INVALID_TILE; ///< Tile with the reservation that blocked the last path reservation of the train, if it is known.
+	Trackdir blocked_trackdir = Trackdir::Invalid; ///< Trackdir that could not be reserved on #blocked_tile.
+
 	/** Create new Train object. @copydoc GroundVehicle::GroundVehicle */
 	Train(VehicleID index) : GroundVehicleBase(index) {}
 	/** We want to 'destruct' the right class. */
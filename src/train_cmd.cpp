@@ -58,6 +58,9 @@ static constexpr DiagDirectionIndexArray<uint8_t> _vehicle_initial_x_fract{10, 8
 /** Initial y subtile coordinate of rail vehicles for each direction. */
 static constexpr DiagDirectionIndexArray<uint8_t> _vehicle_initial_y_fract{ 8, 4, 8, 10};
 
+/** Number of path back-off intervals between retries of a stuck train while the reservation blocking its path is still there. */
+static const uint BLOCKED_PATH_BACKOFF_FACTOR = 4;
+
 /** @copydoc IsValidImageIndex */
 template <>
 bool IsValidImageIndex<VehicleType::Train>(uint8_t image_index)
@@ -1737,6 +1740,9 @@ static bool IsTrain(const Vehicle *v)
 	return v->type == VehicleType::Train;
 }
 
+/** Number of train vehicles on each level crossing tile that has any. */
+static std::unordered_map<TileIndex, uint> _level_crossing_occupancy;
+
 /**
  * Check if a level crossing tile has a train on it
  * @param tile tile to test
@@ -1747,7 +1753,55 @@ bool TrainOnCrossing(TileIndex tile)
 {
 	assert(IsLevelCrossingTile(tile));
 
-	return HasVehicleOnTile(tile, IsTrain);
+	return _level_crossing_occupancy.contains(tile);
+}
+
+/**
+ * Update the level crossing occupancy for a train vehicle that got a new position in the vehicle tile hash.
+ * A vehicle is counted on the tile it is on when that tile is a level crossing, so the
+ * count only changes when the vehicle moves to another tile or when it gets removed.
+ * @param v The train vehicle.
+ * @param tile The tile of the vehicle, or \c INVALID_TILE when it is removed from the tile hash.
+ */
+void UpdateLevelCrossingOccupancy(Vehicle *v, TileIndex tile)
+{
+	if (tile == v->hash_crossing_tile) return;
+	if (tile != INVALID_TILE && !IsLevelCrossingTile(tile)) tile = INVALID_TILE;
+	if (tile == v->hash_crossing_tile) return;
+
+	if (v->hash_crossing_tile != INVALID_TILE) {
+		auto it = _level_crossing_occupancy.find(v->hash_crossing_tile);
+		assert(it != _level_crossing_occupancy.end());
+		if (--it->second == 0) _level_crossing_occupancy.erase(it);
+	}
+	if (tile != INVALID_TILE) _level_crossing_occupancy[tile]++;
+	v->hash_crossing_tile = tile;
+}
+
+/**
+ * Count the trains on a tile that just became a level crossing, or
+ * recount all of them after the map has been converted when loading.
+ * @param tile The tile to count, or \c INVALID_TILE for all tiles.
+ */
+void RecountLevelCrossingOccupancy(TileIndex tile)
+{
+	if (tile != INVALID_TILE) {
+		for (Vehicle *v : VehiclesOnTile(tile)) {
+			if (v->type == VehicleType::Train) UpdateLevelCrossingOccupancy(v, tile);
+		}
+		return;
+	}
+
+	for (Train *v : Train::Iterate()) {
+		if (v->hash_tile_current != nullptr) UpdateLevelCrossingOccupancy(v, v->tile);
+	}
+}
+
+/** Forget all level crossing occupancy, for when the vehicle tile hash gets reset. */
+void ResetLevelCrossingOccupancy()
+{
+	_level_crossing_occupancy.clear();
+	for (Train *v : Train::Iterate()) v->hash_crossing_tile = INVALID_TILE;
 }
 
 /**
@@ -2765,6 +2819,29 @@ public:
 	}
 };
 
+/**
+ * Remember which reservation prevented a train from reserving its path.
+ * @param consist The train.
+ * @param res_dest Result of the failed reservation attempt.
+ */
+static void SetTrainPathBlocked(Train *consist, const PBSTileInfo &res_dest)
+{
+	consist->blocked_tile = res_dest.blocked_tile;
+	consist->blocked_trackdir = res_dest.blocked_trackdir;
+}
+
+/**
+ * Check whether the reservation that prevented a stuck train from reserving its path is still there.
+ * As long as it is, trying to reserve the same path again is pointless.
+ * @param consist The train.
+ * @return True if the blocking reservation is known and still present.
+ */
+static bool IsTrainPathStillBlocked(const Train *consist)
+{
+	if (consist->blocked_tile == INVALID_TILE) return false;
+	return TrackOverlapsTracks(GetReservedTrackbits(consist->blocked_tile), TrackdirToTrack(consist->blocked_trackdir));
+}
+
 /* choose a track */
 static Track ChooseTrainTrack(Train *consist, TileIndex tile, DiagDirection enterdir, TrackBits tracks, bool force_res, bool *got_reservation, bool mark_stuck)
 {
@@ -2776,6 +2853,7 @@ static Track ChooseTrainTrack(Train *consist, TileIndex tile, DiagDirection ente
 	assert(tracks == (tracks & TRACK_BIT_ALL));
 
 	if (got_reservation != nullptr) *got_reservation = false;
+	consist->blocked_tile = INVALID_TILE;
 
 	/* Don't use tracks here as the setting to forbid 90 deg turns might have been switched between reservation and now. */
 	TrackBits res_tracks = GetReservedTrackbits(tile) & DiagdirReachesTracks(enterdir);
@@ -2856,6 +2934,7 @@ static Track ChooseTrainTrack(Train *consist, TileIndex tile, DiagDirection ente
 
 	/* A path was found, but could not be reserved. */
 	if (res_dest.tile != INVALID_TILE && !res_dest.okay) {
+		SetTrainPathBlocked(consist, res_dest);
 		if (mark_stuck) MarkTrainAsStuck(consist);
 		FreeTrainTrackReservation(consist);
 		return best_track;
@@ -2899,6 +2978,7 @@ static Track ChooseTrainTrack(Train *consist, TileIndex tile, DiagDirection ente
 				res_dest = cur_dest;
 				if (res_dest.okay) continue;
 				/* Path found, but could not be reserved. */
+				SetTrainPathBlocked(consist, cur_dest);
 				FreeTrainTrackReservation(consist);
 				if (mark_stuck) MarkTrainAsStuck(consist);
 				if (got_reservation != nullptr) *got_reservation = false;
@@ -2944,6 +3024,7 @@ bool TryPathReserve(Train *consist, bool mark_as_stuck, bool first_tile_okay)
 {
 	assert(consist->IsFrontEngine());
 
+	consist->blocked_tile = INVALID_TILE;
 	const Train *moving_front = consist->GetMovingFront();
 
 	/* We have to handle depots specially as the track follower won't look
@@ -4068,6 +4149,9 @@ static bool TrainLocoHandler(Train *consist, bool mode)
 		bool turn_around = consist->wait_counter % (_settings_game.pf.wait_for_pbs_path * Ticks::DAY_TICKS) == 0 && _settings_game.pf.reverse_at_signals;
 
 		if (!turn_around && consist->wait_counter % _settings_game.pf.path_backoff_interval != 0 && consist->force_proceed == TFP_NONE) return true;
+		/* While the reservation that blocked our path is still there, only retry occasionally in case another path opened up. */
+		if (!turn_around && consist->force_proceed == TFP_NONE && IsTrainPathStillBlocked(consist) &&
+				consist->wait_counter % (_settings_game.pf.path_backoff_interval * BLOCKED_PATH_BACKOFF_FACTOR) != 0) return true;
 		if (!TryPathReserve(consist)) {
 			/* Still stuck. */
 			if (turn_around) ReverseTrainDirection(consist);
@@ -631,6 +631,8 @@ static void UpdateVehicleTileHash(Vehicle *v, bool remove)
 		new_hash = &_vehicle_tile_hash[GetTileHash(TileX(v->tile), TileY(v->tile))];
 	}
 
+	if (v->type == VehicleType::Train) UpdateLevelCrossingOccupancy(v, remove ? INVALID_TILE : v->tile);
+
 	if (old_hash == new_hash) return;
 
 	/* Remove from the old position in the hash table */
@@ -680,6 +682,7 @@ static void UpdateVehicleViewportHash(Vehicle *v, int x, int y, int old_x, int o
 void ResetVehicleHash()
 {
 	for (Vehicle *v : Vehicle::Iterate()) { v->hash_tile_current = nullptr; }
+	ResetLevelCrossingOccupancy();
 	_vehicle_viewport_hash.fill(nullptr);
 	_vehicle_tile_hash.fill(nullptr);
 }
@@ -988,6 +991,9 @@ void CallVehicleTicks()
 
 	RunEconomyVehicleDayProc();
 
+	/* Remember vehicle callback results while ticking the vehicles; not during autoreplace further down. */
+	Backup<bool> memoise_callbacks(_memoise_vehicle_callbacks, true);
+
 	{
 		PerformanceMeasurer framerate(PerformanceElement::GameLoopEconomy);
 		for (Station *st : Station::Iterate()) LoadUnloadStation(st);
@@ -997,6 +1003,8 @@ void CallVehicleTicks()
 	PerformanceAccumulator::Reset(PerformanceElement::GameLoopShips);
 	PerformanceAccumulator::Reset(PerformanceElement::GameLoopAircraft);
 
+	PrefetchRoadVehiclePaths();
+
 	for (Vehicle *v : Vehicle::Iterate()) {
 		[[maybe_unused]] VehicleID vehicle_index = v->index;
 
@@ -1069,6 +1077,7 @@ void CallVehicleTicks()
 			}
 		}
 	}
+	memoise_callbacks.Restore();
 
 	for (auto &it : _vehicles_to_autoreplace) {
 		Vehicle *v = Vehicle::Get(it.first);
@@ -16,6 +16,7 @@
 #include "order_base.h"
 #include "cargopacket.h"
 #include "newgrf_type.h"
+#include "newgrf_callbacks.h"
 #include "texteff.hpp"
 #include "engine_type.h"
 #include "order_func.h"
@@ -67,6 +68,18 @@ struct NewGRFCache {
 	auto operator<=>(const NewGRFCache &) const = default;
 };
 
+/** Result of a vehicle callback, remembered for the rest of the tick by #GetVehicleCallback. */
+struct VehicleCallbackMemo {
+	uint64_t tick = UINT64_MAX; ///< Tick the result is valid in; by default never.
+	EngineID engine = EngineID::Invalid(); ///< Engine the callback was resolved for.
+	CallbackID callback = CBID_NO_CALLBACK; ///< The callback.
+	uint32_t param1 = 0; ///< First parameter of the callback.
+	uint32_t param2 = 0; ///< Second parameter of the callback.
+	CargoType cargo_type = INVALID_CARGO; ///< Cargo type of the vehicle; refitting temporarily changes it.
+	uint8_t cargo_subtype = 0; ///< Cargo subtype of the vehicle; refitting temporarily changes it.
+	uint16_t result = 0; ///< Result of the callback.
+};
+
 /**
  * Enum to handle ground vehicle subtypes.
  * This is defined here instead of at #GroundVehicle because some common function require access to these flags.
@@ -239,6 +252,7 @@ public:
 	Vehicle *hash_tile_next = nullptr; ///< NOSAVE: Next vehicle in the tile location hash.
 	Vehicle **hash_tile_prev = nullptr; ///< NOSAVE: Previous vehicle in the tile location hash.
 	Vehicle **hash_tile_current = nullptr; ///< NOSAVE: Cache of the current hash chain.
+	TileIndex hash_crossing_tile = INVALID_TILE; ///< NOSAVE: Level crossing tile this train vehicle is counted on, see #UpdateLevelCrossingOccupancy.
 
 	SpriteID colourmap{}; ///< NOSAVE: cached colour mapping
 
@@ -310,6 +324,7 @@ public:
 	};
 
 	NewGRFCache grf_cache{}; ///< Cache of often used calculated NewGRF values
+	mutable std::array<VehicleCallbackMemo, 4> callback_memo{}; ///< NOSAVE: Callback results of this tick, cleared together with #grf_cache.
 	VehicleCache vcache{}; ///< Cache of often used vehicle values.
 
 	GroupID group_id = GroupID::Invalid(); ///< Index of group Pool array
@@ -495,6 +510,7 @@ public:
 	inline void InvalidateNewGRFCache()
 	{
 		this->grf_cache.cache_valid = 0;
+		this->callback_memo = {};
 	}
 
 	/**
@@ -10,8 +10,17 @@
 #include "../stdafx.h"
 #include "../gfx_func.h"
 #include "../blitter/factory.hpp"
+#include "../core/backup_type.hpp"
+#include "../core/string_consumer.hpp"
+#include "../error_func.h"
+#include "../fileio_func.h"
+#include "../landscape.h"
+#include "../openttd.h"
 #include "../saveload/saveload_func.h"
+#include "../viewport_func.h"
 #include "../window_func.h"
+#include "../worker_pool.h"
+#include "../zoom_func.h"
 #include "null_v.h"
 
 #include "../safeguards.h"
@@ -36,6 +45,17 @@ std::optional<std::string_view> VideoDriver_Null::Start(const StringList &parm)
 	_screen.dst_ptr = nullptr;
 	ScreenSizeChanged();
 
+	auto render_bench = GetDriverParam(parm, "render_bench");
+	if (render_bench.has_value()) {
+		/* Render into an offscreen buffer, with the blitter that was selected. */
+		if (BlitterFactory::GetCurrentBlitter()->GetScreenDepth() == 0) return "the render benchmark needs a blitter that draws";
+
+		this->render_bench = *render_bench;
+		this->render_frames = std::max(GetDriverParamInt(parm, "frames", 10), 1);
+		this->AllocateRenderBuffer();
+		return std::nullopt;
+	}
+
 	/* Do not render, nor blit */
 	Debug(misc, 1, "Forcing blitter 'null'...");
 	BlitterFactory::SelectBlitter("null");
@@ -48,6 +68,11 @@ void VideoDriver_Null::MakeDirty(int, int, int, int) {}
 
 void VideoDriver_Null::MainLoop()
 {
+	if (this->render_bench.has_value()) {
+		this->RenderBenchmark();
+		return;
+	}
+
 	uint i;
 
 	for (i = 0; i < this->ticks; i++) {
@@ -66,3 +91,159 @@ void VideoDriver_Null::MainLoop()
 bool VideoDriver_Null::ChangeResolution(int, int) { return false; }
 
 bool VideoDriver_Null::ToggleFullscreen(bool) { return false; }
+
+bool VideoDriver_Null::AfterBlitterChange()
+{
+	if (this->render_bench.has_value()) this->AllocateRenderBuffer();
+	return true;
+}
+
+/** Allocate the offscreen buffer of the render benchmark for the current blitter and screen size. */
+void VideoDriver_Null::AllocateRenderBuffer()
+{
+	Blitter *blitter = BlitterFactory::GetCurrentBlitter();
+	this->render_buffer.assign(blitter->BufferSize(_screen.pitch, _screen.height), 0);
+	_screen.dst_ptr = this->render_buffer.data();
+	blitter->PostResize();
+}
+
+/** A position of the render benchmark. */
+struct RenderBenchPosition {
+	uint x; ///< X coordinate of the tile in the centre of the screen.
+	uint y; ///< Y coordinate of the tile in the centre of the screen.
+	ZoomLevel zoom; ///< Zoom level to render at.
+};
+
+/**
+ * Get the positions to render in the render benchmark.
+ * @param filename File with a position per line: the x and y coordinate of the tile in the centre and the zoom level,
+ *                 separated by spaces. Empty lines and lines starting with \c # are skipped.
+ *                 When empty, the centre of the map is rendered at every zoom level that is allowed.
+ * @return The positions.
+ */
+static std::vector<RenderBenchPosition> GetRenderBenchPositions(const std::string &filename)
+{
+	std::vector<RenderBenchPosition> positions;
+	if (filename.empty()) {
+		for (ZoomLevel zoom = _settings_client.gui.zoom_min; zoom <= _settings_client.gui.zoom_max; zoom++) {
+			positions.emplace_back(Map::SizeX() / 2, Map::SizeY() / 2, zoom);
+		}
+		return positions;
+	}
+
+	auto file = FileHandle::Open(filename, "r");
+	if (!file.has_value()) UserError("Could not open render benchmark positions '{}'", filename);
+
+	char buffer[256];
+	while (fgets(buffer, sizeof(buffer), *file) != nullptr) {
+		StringConsumer consumer{std::string_view{buffer}};
+		consumer.SkipUntilCharNotIn(StringConsumer::WHITESPACE_OR_NEWLINE);
+		if (!consumer.AnyBytesLeft() || consumer.PeekCharIf('#')) continue;
+
+		auto x = consumer.TryReadIntegerBase<uint>(10);
+		consumer.SkipUntilCharNotIn(StringConsumer::WHITESPACE_NO_NEWLINE);
+		auto y = consumer.TryReadIntegerBase<uint>(10);
+		consumer.SkipUntilCharNotIn(StringConsumer::WHITESPACE_NO_NEWLINE);
+		auto zoom = consumer.TryReadIntegerBase<uint>(10);
+		if (!x.has_value() || !y.has_value() || !zoom.has_value() || *zoom > to_underlying(ZoomLevel::Max)) {
+			UserError("Invalid render benchmark position: {}", buffer);
+		}
+
+		positions.emplace_back(std::min(*x, Map::MaxX()), std::min(*y, Map::MaxY()), static_cast<ZoomLevel>(*zoom));
+	}
+	return positions;
+}
+
+/**
+ * Get the time spent in a stage of the render benchmark, per frame.
+ * @param duration The time spent in all frames.
+ * @param frames The number of frames.
+ * @return Milliseconds per frame.
+ */
+static double GetRenderBenchMilliseconds(std::chrono::steady_clock::duration duration, uint frames)
+{
+	return std::chrono::duration<double, std::milli>(duration).count() / frames;
+}
+
+/**
+ * Render the positions of the render benchmark into the offscreen buffer, and write the time
+ * spent in each stage of drawing the viewport as JSON to the standard output. Then run the
+ * game for as many ticks as frames, and report the redrawing of the dirty parts of the screen.
+ */
+void VideoDriver_Null::RenderBenchmark()
+{
+	/* Let the game load what it was started with, such as a savegame. */
+	do {
+		::GameLoop();
+	} while (_switch_mode != SwitchMode::None);
+
+	std::vector<RenderBenchPosition> positions = GetRenderBenchPositions(*this->render_bench);
+
+	fmt::print("{{\n  \"blitter\": \"{}\",\n  \"width\": {},\n  \"height\": {},\n  \"frames\": {},\n  \"workers\": {},\n  \"positions\": [",
+			BlitterFactory::GetCurrentBlitter()->GetName(), _screen.width, _screen.height, this->render_frames, GetWorkerCount());
+
+	for (size_t i = 0; i < positions.size(); i++) {
+		const RenderBenchPosition &position = positions[i];
+
+		Viewport vp{};
+		vp.zoom = position.zoom;
+		vp.width = _screen.width;
+		vp.height = _screen.height;
+		vp.virtual_width = ScaleByZoom(vp.width, vp.zoom);
+		vp.virtual_height = ScaleByZoom(vp.height, vp.zoom);
+		Point centre = RemapCoords(position.x * TILE_SIZE + TILE_SIZE / 2, position.y * TILE_SIZE + TILE_SIZE / 2, TilePixelHeight(TileXY(position.x, position.y)));
+		vp.virtual_left = centre.x - vp.virtual_width / 2;
+		vp.virtual_top = centre.y - vp.virtual_height / 2;
+
+		DrawPixelInfo dpi{
+			.dst_ptr = _screen.dst_ptr,
+			.left = 0,
+			.top = 0,
+			.width = _screen.width,
+			.height = _screen.height,
+			.pitch = _screen.pitch,
+			.zoom = ZoomLevel::Min
+		};
+		AutoRestoreBackup dpi_backup(_cur_dpi, &dpi);
+
+		ViewportDrawTimings timings;
+		AutoRestoreBackup timings_backup(_viewport_draw_timings, &timings);
+
+		auto start = std::chrono::steady_clock::now();
+		for (uint frame = 0; frame < this->render_frames; frame++) {
+			ViewportDoDraw(vp, vp.virtual_left, vp.virtual_top, vp.virtual_left + vp.virtual_width, vp.virtual_top + vp.virtual_height);
+		}
+		auto total = std::chrono::steady_clock::now() - start;
+
+		fmt::print("{}\n    {{\"x\": {}, \"y\": {}, \"zoom\": {}, \"total_ms\": {:.3f}, \"landscape_ms\": {:.3f}, \"vehicles_ms\": {:.3f}, \"signs_ms\": {:.3f}, "
+				"\"sort_ms\": {:.3f}, \"prepare_ms\": {:.3f}, \"blit_ms\": {:.3f}, \"strings_ms\": {:.3f}}}",
+				i == 0 ? "" : ",", position.x, position.y, to_underlying(position.zoom),
+				GetRenderBenchMilliseconds(total, this->render_frames),
+				GetRenderBenchMilliseconds(timings.landscape, this->render_frames),
+				GetRenderBenchMilliseconds(timings.vehicles, this->render_frames),
+				GetRenderBenchMilliseconds(timings.signs, this->render_frames),
+				GetRenderBenchMilliseconds(timings.sort, this->render_frames),
+				GetRenderBenchMilliseconds(timings.prepare, this->render_frames),
+				GetRenderBenchMilliseconds(timings.blit, this->render_frames),
+				GetRenderBenchMilliseconds(timings.strings, this->render_frames));
+	}
+
+	/* Let the game run, and measure redrawing what it marked dirty, e.g. moving vehicles. */
+	DirtyRedrawStats stats;
+	{
+		AutoRestoreBackup stats_backup(_dirty_redraw_stats, &stats);
+		MarkWholeScreenDirty();
+		::UpdateWindows();
+		stats = {};
+
+		for (uint frame = 0; frame < this->render_frames; frame++) {
+			::GameLoop();
+			::UpdateWindows();
+		}
+	}
+
+	uint64_t calls = std::max<uint64_t>(stats.calls, 1);
+	fmt::print("\n  ],\n  \"redraw\": {{\"ticks\": {}, \"ms\": {:.3f}, \"rects\": {:.1f}, \"pixels\": {:.0f}}}\n}}\n",
+			this->render_frames, GetRenderBenchMilliseconds(stats.time, static_cast<uint>(calls)),
+			static_cast<double>(stats.rects) / calls, static_cast<double>(stats.pixels) / calls);
+}
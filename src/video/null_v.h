@@ -16,6 +16,12 @@
 class VideoDriver_Null : public VideoDriver {
 private:
 	uint ticks = 0; ///< Amount of ticks to run.
+	std::optional<std::string> render_bench; ///< File with the positions to render in the render benchmark, empty for the default positions, or \c std::nullopt when not benchmarking.
+	uint render_frames = 0; ///< Number of frames to render of each position in the render benchmark.
+	std::vector<uint8_t> render_buffer; ///< Offscreen buffer the render benchmark draws into.
+
+	void AllocateRenderBuffer();
+	void RenderBenchmark();
 
 public:
 	std::optional<std::string_view> Start(const StringList &param) override;
@@ -29,6 +35,8 @@ public:
 	bool ChangeResolution(int w, int h) override;
 
 	bool ToggleFullscreen(bool fullscreen) override;
+
+	bool AfterBlitterChange() override;
 	std::string_view GetName() const override { return "null"; }
 	bool HasGUI() const override { return false; }
 };
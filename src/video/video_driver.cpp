@@ -36,10 +36,16 @@ void VideoDriver::GameLoop()
 	if (this->next_game_tick < now - ALLOWED_DRIFT * this->GetGameInterval()) this->next_game_tick = now;
 
 	{
+		this->game_tick_pending = true;
 		std::lock_guard<std::mutex> lock(this->game_state_mutex);
+		this->game_tick_pending = false;
 
+		auto start = std::chrono::steady_clock::now();
 		::GameLoop();
+		this->last_game_tick_duration = std::chrono::steady_clock::now() - start;
+		this->game_tick_count++;
 	}
+	this->game_tick_done.notify_all();
 }
 
 void VideoDriver::GameThread()
@@ -126,7 +132,7 @@ void VideoDriver::Tick()
 		{
 			/* Tell the game-thread to stop so we can have a go. */
 			std::lock_guard<std::mutex> lock_wait(this->game_thread_wait_mutex);
-			std::lock_guard<std::mutex> lock_state(this->game_state_mutex);
+			std::unique_lock<std::mutex> lock_state(this->game_state_mutex);
 
 			/* Keep the interactive randomizer a bit more random by requesting
 			 * new values when-ever we can. */
@@ -148,6 +154,18 @@ void VideoDriver::Tick()
 
 			::InputLoop();
 
+			/* The input is handled; if a game tick became due meanwhile, let it run
+			 * before drawing, so a slow draw does not make the game lag behind. The
+			 * windows then get drawn with the state after that tick. Once the game
+			 * thread has the lock, waiting cannot be cut short, so only do this when
+			 * the last tick was quick; a long tick would stall this frame instead,
+			 * so then the tick waits for the draw like before. */
+			if (this->game_tick_pending && this->last_game_tick_duration.load() < this->GetDrawInterval() / 2) {
+				uint64_t count = this->game_tick_count;
+				/* The timeout only helps when the tick pauses itself, see GameLoopPause(). */
+				this->game_tick_done.wait_for(lock_state, this->GetGameInterval(), [this, count]() { return this->game_tick_count != count; });
+			}
+
 			/* Prevent drawing when switching mode, as windows can be removed when they should still appear. */
 			if (_game_mode == GameMode::Bootstrap || _switch_mode == SwitchMode::None || HasModalProgress()) {
 				::UpdateWindows();
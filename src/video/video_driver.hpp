@@ -365,6 +365,10 @@ protected:
 	std::thread game_thread;
 	std::mutex game_state_mutex;
 	std::mutex game_thread_wait_mutex;
+	std::atomic<bool> game_tick_pending = false; ///< The game-thread is waiting for the game-state lock to run a tick.
+	std::condition_variable game_tick_done; ///< Signalled when the game-thread finished a tick.
+	uint64_t game_tick_count = 0; ///< Number of game ticks run by the game-thread; only accessed with the game-state lock.
+	std::atomic<std::chrono::steady_clock::duration> last_game_tick_duration{}; ///< How long the last game tick took, to decide whether drawing waits for a due tick.
 
 	bool uses_hardware_acceleration;
 
@@ -90,6 +90,9 @@
 #include "network/network_func.h"
 #include "framerate_type.h"
 #include "viewport_cmd.h"
+#include "newgrf_debug.h"
+#include "smallmap_gui.h"
+#include "worker_pool.h"
 
 #include <forward_list>
 #include <stack>
@@ -175,6 +178,7 @@ struct ViewportDrawer {
 	ParentSpriteToDrawVector parent_sprites_to_draw;
 	ParentSpriteToSortVector parent_sprites_to_sort; ///< Parent sprite pointer array used for sorting
 	ChildScreenSpriteToDrawVector child_screen_sprites_to_draw;
+	std::vector<PreparedViewportSprite> sprites_to_blit; ///< Sprites in drawing order, with their sprite data looked up.
 
 	int last_child;
 
@@ -190,6 +194,15 @@ static bool MarkViewportDirty(const Viewport &vp, int left, int top, int right,
 
 static ViewportDrawer _vd;
 
+/** Width and height of the parts of a viewport that are drawn independently, in screen pixels. */
+static const int VIEWPORT_SCREEN_TILE_SIZE = 256;
+/** Drawers of the parts of the viewport being drawn; kept so their buffers are reused. */
+static std::vector<ViewportDrawer> _vd_screen_tiles;
+/** Strings of all parts of the viewport being drawn, without the duplicates; kept so its buffer is reused. */
+static StringSpriteToDrawVector _vd_screen_strings;
+
+ViewportDrawTimings *_viewport_draw_timings = nullptr; ///< Where to add the time spent drawing viewports, or \c nullptr when it is not measured.
+
 TileHighlightData _thd;
 static TileInfo _cur_ti;
 bool _draw_bounding_boxes = false;
@@ -1349,6 +1362,26 @@ std::string *ViewportAddString(const DrawPixelInfo *dpi, const ViewportSign *sig
 	return &AddStringToDraw(sign->center - sign_half_width, sign->top, colour, flags, small ? sign->width_small : sign->width_normal);
 }
 
+/**
+ * Add the text of a sign to draw in the current viewport.
+ * The text is formatted only when it is not cached in the sign yet.
+ * @param dpi current viewport area
+ * @param sign sign position and dimension
+ * @param flags ViewportStringFlags to control the string's appearance.
+ * @param colour colour of the sign background; or Colours::Invalid if transparent
+ * @param format Function that formats the text of the sign.
+ */
+template <typename Tformat>
+static void ViewportAddSignText(const DrawPixelInfo *dpi, const ViewportSign &sign, ViewportStringFlags flags, Colours colour, Tformat &&format)
+{
+	std::string *str = ViewportAddString(dpi, &sign, flags, colour);
+	if (str == nullptr) return;
+
+	std::string &text = flags.Test(ViewportStringFlag::Small) ? sign.text.small : sign.text.normal;
+	if (text.empty()) text = format();
+	*str = text;
+}
+
 static Rect ExpandRectWithViewportSignMargins(Rect r, ZoomLevel zoom)
 {
 	const int fh = std::max(GetCharacterHeight(FontSize::Normal), GetCharacterHeight(FontSize::Small));
@@ -1382,14 +1415,9 @@ static void ViewportAddTownStrings(DrawPixelInfo *dpi, const std::vector<const T
 	}
 
 	for (const Town *t : towns) {
-		std::string *str = ViewportAddString(dpi, &t->cache.sign, flags, Colours::Invalid);
-		if (str == nullptr) continue;
-
-		if (t->larger_town) {
-			*str = GetString(stringid_town_city, t->index, t->cache.population);
-		} else {
-			*str = GetString(stringid_town, t->index, t->cache.population);
-		}
+		ViewportAddSignText(dpi, t->cache.sign, flags, Colours::Invalid, [&]() {
+			return GetString(t->larger_town ? stringid_town_city : stringid_town, t->index, t->cache.population);
+		});
 	}
 }
 
@@ -1415,11 +1443,9 @@ static void ViewportAddSignStrings(DrawPixelInfo *dpi, const std::vector<const S
 		 * colours that are not Colours::Invalid slightly, turning white into a light gray. */
 		const Colours deity_colour = si->text_colour == Colours::White ? Colours::Invalid : si->text_colour;
 
-		std::string *str = ViewportAddString(dpi, &si->sign, (si->owner == OWNER_DEITY) ? deity_flags : flags,
-			(si->owner == OWNER_NONE) ? Colours::Grey : (si->owner == OWNER_DEITY ? deity_colour : _company_colours[si->owner]));
-		if (str == nullptr) continue;
-
-		*str = GetString(STR_SIGN_NAME, si->index);
+		ViewportAddSignText(dpi, si->sign, (si->owner == OWNER_DEITY) ? deity_flags : flags,
+			(si->owner == OWNER_NONE) ? Colours::Grey : (si->owner == OWNER_DEITY ? deity_colour : _company_colours[si->owner]),
+			[si]() { return GetString(STR_SIGN_NAME, si->index); });
 	}
 }
 
@@ -1436,14 +1462,13 @@ static void ViewportAddStationStrings(DrawPixelInfo *dpi, const std::vector<cons
 	if (small) flags.Set(ViewportStringFlag::Small);
 
 	for (const BaseStation *st : stations) {
-		std::string *str = ViewportAddString(dpi, &st->sign, flags, (st->owner == OWNER_NONE || !st->IsInUse()) ? Colours::Grey : _company_colours[st->owner]);
-		if (str == nullptr) continue;
-
-		if (Station::IsExpected(st)) { /* Station */
-			*str = GetString(small ? STR_STATION_NAME : STR_VIEWPORT_STATION, st->index, st->facilities);
-		} else { /* Waypoint */
-			*str = GetString(STR_WAYPOINT_NAME, st->index);
-		}
+		ViewportAddSignText(dpi, st->sign, flags, (st->owner == OWNER_NONE || !st->IsInUse()) ? Colours::Grey : _company_colours[st->owner], [st, small]() {
+			if (Station::IsExpected(st)) { /* Station */
+				return GetString(small ? STR_STATION_NAME : STR_VIEWPORT_STATION, st->index, st->facilities);
+			} else { /* Waypoint */
+				return GetString(STR_WAYPOINT_NAME, st->index);
+			}
+		});
 	}
 }
 
@@ -1542,6 +1567,7 @@ void ViewportSign::UpdatePosition(int center, int top, std::string_view str, std
 	if (this->width_normal != 0) this->MarkDirty();
 
 	this->top = top;
+	this->text = {};
 
 	this->width_normal = WidgetDimensions::scaled.fullbevel.left + Align(GetStringBoundingBox(str).width, 2) + WidgetDimensions::scaled.fullbevel.right;
 	this->center = center;
@@ -1586,10 +1612,10 @@ void ViewportSign::MarkDirty(ZoomLevel maxzoom) const
 	}
 }
 
-static void ViewportDrawTileSprites(const TileSpriteToDrawVector *tstdv)
+static void ViewportPrepareTileSprites(const TileSpriteToDrawVector *tstdv, std::vector<PreparedViewportSprite> *sprites)
 {
 	for (const TileSpriteToDraw &ts : *tstdv) {
-		DrawSpriteViewport(ts.image, ts.pal, ts.x, ts.y, ts.sub);
+		sprites->push_back(PrepareSpriteViewport(ts.image, ts.pal, ts.x, ts.y, ts.sub));
 	}
 }
 
@@ -1717,19 +1743,19 @@ static void ViewportSortParentSprites(ParentSpriteToSortVector *psdv)
 }
 
 
-static void ViewportDrawParentSprites(const ParentSpriteToSortVector *psd, const ChildScreenSpriteToDrawVector *csstdv)
+static void ViewportPrepareParentSprites(const ParentSpriteToSortVector *psd, const ChildScreenSpriteToDrawVector *csstdv, std::vector<PreparedViewportSprite> *sprites)
 {
 	for (const ParentSpriteToDraw *ps : *psd) {
-		if (ps->image != SPR_EMPTY_BOUNDING_BOX) DrawSpriteViewport(ps->image, ps->pal, ps->x, ps->y, ps->sub);
+		if (ps->image != SPR_EMPTY_BOUNDING_BOX) sprites->push_back(PrepareSpriteViewport(ps->image, ps->pal, ps->x, ps->y, ps->sub));
 
 		int child_idx = ps->first_child;
 		while (child_idx >= 0) {
 			const ChildScreenSpriteToDraw *cs = &(*csstdv)[child_idx];
 			child_idx = cs->next;
 			if (cs->relative) {
-				DrawSpriteViewport(cs->image, cs->pal, ps->left + cs->x, ps->top + cs->y, cs->sub);
+				sprites->push_back(PrepareSpriteViewport(cs->image, cs->pal, ps->left + cs->x, ps->top + cs->y, cs->sub));
 			} else {
-				DrawSpriteViewport(cs->image, cs->pal, ps->x + cs->x, ps->y + cs->y, cs->sub);
+				sprites->push_back(PrepareSpriteViewport(cs->image, cs->pal, ps->x + cs->x, ps->y + cs->y, cs->sub));
 			}
 		}
 	}
@@ -1812,71 +1838,198 @@ static void ViewportDrawStrings(ZoomLevel zoom, const StringSpriteToDrawVector *
 	}
 }
 
-void ViewportDoDraw(const Viewport &vp, int left, int top, int right, int bottom)
+/**
+ * Draw the strings of a part of a viewport.
+ * @param zoom The zoom level of the viewport.
+ * @param dpi The area to draw in, in virtual coordinates.
+ * @param strings The strings to draw.
+ */
+static void ViewportDrawTileStrings(ZoomLevel zoom, const DrawPixelInfo &dpi, const StringSpriteToDrawVector &strings)
 {
-	_vd.dpi.zoom = vp.zoom;
-	int mask = ScaleByZoom(-1, vp.zoom);
+	if (strings.empty()) return;
 
-	_vd.combine_sprites = SpriteCombineMode::None;
+	DrawPixelInfo dp = dpi;
+	dp.zoom = ZoomLevel::Min;
+	dp.width = UnScaleByZoom(dpi.width, zoom);
+	dp.height = UnScaleByZoom(dpi.height, zoom);
+	/* translate to world coordinates */
+	dp.left = UnScaleByZoom(dpi.left, zoom);
+	dp.top = UnScaleByZoom(dpi.top, zoom);
+	AutoRestoreBackup cur_dpi(_cur_dpi, &dp);
+	ViewportDrawStrings(zoom, &strings);
+}
+
+/**
+ * Add the time since the start of a stage of drawing viewports to that stage, when it is measured.
+ * @param stage The stage that is done.
+ * @param[in,out] start The start of the stage; set to the start of the next stage.
+ */
+static void ViewportDrawStageDone(ViewportDrawTimings::Duration ViewportDrawTimings::*stage, std::chrono::steady_clock::time_point &start)
+{
+	if (_viewport_draw_timings == nullptr) return;
+
+	auto now = std::chrono::steady_clock::now();
+	_viewport_draw_timings->*stage += now - start;
+	start = now;
+}
 
-	_vd.dpi.width = (right - left) & mask;
-	_vd.dpi.height = (bottom - top) & mask;
-	_vd.dpi.left = left & mask;
-	_vd.dpi.top = top & mask;
-	_vd.dpi.pitch = _cur_dpi->pitch;
+/**
+ * Collect the sprites and strings of a part of a viewport.
+ * @param drawer The drawer of the part, with its \c dpi set up.
+ */
+static void ViewportCollectScreenTile(ViewportDrawer &drawer)
+{
+	std::swap(_vd, drawer);
+	_vd.combine_sprites = SpriteCombineMode::None;
 	_vd.last_child = LAST_CHILD_NONE;
 
-	int x = UnScaleByZoom(_vd.dpi.left - (vp.virtual_left & mask), vp.zoom) + vp.left;
-	int y = UnScaleByZoom(_vd.dpi.top - (vp.virtual_top & mask), vp.zoom) + vp.top;
+	{
+		AutoRestoreBackup dpi_backup(_cur_dpi, &_vd.dpi);
+		auto stage_start = std::chrono::steady_clock::now();
 
-	_vd.dpi.dst_ptr = BlitterFactory::GetCurrentBlitter()->MoveTo(_cur_dpi->dst_ptr, x - _cur_dpi->left, y - _cur_dpi->top);
-	AutoRestoreBackup dpi_backup(_cur_dpi, &_vd.dpi);
+		ViewportAddLandscape();
+		ViewportDrawStageDone(&ViewportDrawTimings::landscape, stage_start);
+		ViewportAddVehicles(&_vd.dpi);
+		ViewportDrawStageDone(&ViewportDrawTimings::vehicles, stage_start);
 
-	ViewportAddLandscape();
-	ViewportAddVehicles(&_vd.dpi);
+		ViewportAddKdtreeSigns(&_vd.dpi);
 
-	ViewportAddKdtreeSigns(&_vd.dpi);
+		DrawTextEffects(&_vd.dpi);
+		ViewportDrawStageDone(&ViewportDrawTimings::signs, stage_start);
+	}
 
-	DrawTextEffects(&_vd.dpi);
+	std::swap(_vd, drawer);
+}
 
-	if (!_vd.tile_sprites_to_draw.empty()) ViewportDrawTileSprites(&_vd.tile_sprites_to_draw);
+/**
+ * Draw a part of the viewport.
+ * The viewport is split in tiles of #VIEWPORT_SCREEN_TILE_SIZE pixels that each get their own list of sprites.
+ * Collecting the sprites calls NewGRF callbacks and uses global state, so that is done on this thread, just like
+ * looking up the sprites in the sprite cache. Sorting and blitting the sprites of a tile only touches the data
+ * and the pixels of that tile, so those are spread over the worker threads.
+ * @param vp The viewport to draw.
+ * @param left Left edge of the area to draw, in virtual coordinates.
+ * @param top Top edge of the area to draw, in virtual coordinates.
+ * @param right Right edge of the area to draw, in virtual coordinates.
+ * @param bottom Bottom edge of the area to draw, in virtual coordinates.
+ */
+void ViewportDoDraw(const Viewport &vp, int left, int top, int right, int bottom)
+{
+	int mask = ScaleByZoom(-1, vp.zoom);
+
+	int width = (right - left) & mask;
+	int height = (bottom - top) & mask;
+	left &= mask;
+	top &= mask;
 
-	for (auto &psd : _vd.parent_sprites_to_draw) {
-		_vd.parent_sprites_to_sort.push_back(&psd);
+	int x = UnScaleByZoom(left - (vp.virtual_left & mask), vp.zoom) + vp.left;
+	int y = UnScaleByZoom(top - (vp.virtual_top & mask), vp.zoom) + vp.top;
+
+	/* The sprite picker records the sprites under the cursor while blitting, so it needs a single thread. */
+	int tile_size = width;
+	int tile_height = height;
+	if (GetWorkerCount() > 1 && _newgrf_debug_sprite_picker.mode != SPM_REDRAW) {
+		tile_size = tile_height = ScaleByZoom(VIEWPORT_SCREEN_TILE_SIZE, vp.zoom);
+	}
+	int columns = width > tile_size ? CeilDiv(width, tile_size) : 1;
+	int rows = height > tile_height ? CeilDiv(height, tile_height) : 1;
+
+	Blitter *blitter = BlitterFactory::GetCurrentBlitter();
+	if (_vd_screen_tiles.size() < static_cast<size_t>(columns * rows)) _vd_screen_tiles.resize(columns * rows);
+	std::span<ViewportDrawer> tiles{_vd_screen_tiles.data(), static_cast<size_t>(columns * rows)};
+
+	for (int row = 0; row < rows; row++) {
+		for (int column = 0; column < columns; column++) {
+			DrawPixelInfo &dpi = tiles[row * columns + column].dpi;
+			dpi.zoom = vp.zoom;
+			dpi.left = left + column * tile_size;
+			dpi.top = top + row * tile_height;
+			dpi.width = std::min(tile_size, left + width - dpi.left);
+			dpi.height = std::min(tile_height, top + height - dpi.top);
+			dpi.pitch = _cur_dpi->pitch;
+			dpi.dst_ptr = blitter->MoveTo(_cur_dpi->dst_ptr,
+					x + UnScaleByZoom(dpi.left - left, vp.zoom) - _cur_dpi->left,
+					y + UnScaleByZoom(dpi.top - top, vp.zoom) - _cur_dpi->top);
+
+			ViewportCollectScreenTile(tiles[row * columns + column]);
+		}
 	}
 
-	_vp_sprite_sorter(&_vd.parent_sprites_to_sort);
-	ViewportDrawParentSprites(&_vd.parent_sprites_to_sort, &_vd.child_screen_sprites_to_draw);
+	auto stage_start = std::chrono::steady_clock::now();
+	RunOnWorkers(tiles.size(), [tiles](size_t index) {
+		ViewportDrawer &tile = tiles[index];
+		for (auto &psd : tile.parent_sprites_to_draw) {
+			tile.parent_sprites_to_sort.push_back(&psd);
+		}
+		_vp_sprite_sorter(&tile.parent_sprites_to_sort);
+	});
+	ViewportDrawStageDone(&ViewportDrawTimings::sort, stage_start);
 
-	if (_draw_bounding_boxes) ViewportDrawBoundingBoxes(&_vd.parent_sprites_to_sort);
-	if (_draw_dirty_blocks) ViewportDrawDirtyBlocks();
+	for (ViewportDrawer &tile : tiles) {
+		ViewportPrepareTileSprites(&tile.tile_sprites_to_draw, &tile.sprites_to_blit);
+		ViewportPrepareParentSprites(&tile.parent_sprites_to_sort, &tile.child_screen_sprites_to_draw, &tile.sprites_to_blit);
+	}
+	ViewportDrawStageDone(&ViewportDrawTimings::prepare, stage_start);
 
-	DrawPixelInfo dp = _vd.dpi;
-	ZoomLevel zoom = _vd.dpi.zoom;
-	dp.zoom = ZoomLevel::Min;
-	dp.width = UnScaleByZoom(dp.width, zoom);
-	dp.height = UnScaleByZoom(dp.height, zoom);
-	AutoRestoreBackup cur_dpi(_cur_dpi, &dp);
+	RunOnWorkers(tiles.size(), [tiles](size_t index) {
+		const ViewportDrawer &tile = tiles[index];
+		for (const PreparedViewportSprite &sprite : tile.sprites_to_blit) {
+			DrawPreparedSpriteViewport(sprite, &tile.dpi);
+		}
+	});
+	ViewportDrawStageDone(&ViewportDrawTimings::blit, stage_start);
+
+	if (_draw_bounding_boxes || _draw_dirty_blocks) {
+		for (ViewportDrawer &tile : tiles) {
+			AutoRestoreBackup dpi_backup(_cur_dpi, &tile.dpi);
+			if (_draw_bounding_boxes) ViewportDrawBoundingBoxes(&tile.parent_sprites_to_sort);
+			if (_draw_dirty_blocks) ViewportDrawDirtyBlocks();
+		}
+	}
 
 	if (vp.overlay != nullptr && vp.overlay->GetCargoMask().Any() && vp.overlay->GetCompanyMask().Any()) {
+		DrawPixelInfo dp = tiles[0].dpi;
+		dp.zoom = ZoomLevel::Min;
+		dp.width = UnScaleByZoom(width, vp.zoom);
+		dp.height = UnScaleByZoom(height, vp.zoom);
 		/* translate to window coordinates */
 		dp.left = x;
 		dp.top = y;
+		AutoRestoreBackup cur_dpi(_cur_dpi, &dp);
 		vp.overlay->Draw(&dp);
 	}
 
-	if (!_vd.string_sprites_to_draw.empty()) {
-		/* translate to world coordinates */
-		dp.left = UnScaleByZoom(_vd.dpi.left, zoom);
-		dp.top = UnScaleByZoom(_vd.dpi.top, zoom);
-		ViewportDrawStrings(zoom, &_vd.string_sprites_to_draw);
+	stage_start = std::chrono::steady_clock::now();
+	if (tiles.size() == 1) {
+		ViewportDrawTileStrings(vp.zoom, tiles[0].dpi, tiles[0].string_sprites_to_draw);
+	} else {
+		/* A sign on the edge of screen tiles is in the list of each of them. Drawing the strings once over the
+		 * whole area, instead of clipped in each tile, saves laying out and drawing those signs multiple times. */
+		StringSpriteToDrawVector &strings = _vd_screen_strings;
+		std::set<std::tuple<int32_t, int32_t, ViewportStringFlags::BaseType, Colours, std::string_view>> seen;
+		for (ViewportDrawer &tile : tiles) {
+			for (const StringSpriteToDraw &ss : tile.string_sprites_to_draw) {
+				if (!seen.emplace(ss.x, ss.y, ss.flags.base(), ss.colour, ss.string).second) continue;
+				strings.push_back(ss);
+			}
+		}
+
+		DrawPixelInfo dpi = tiles[0].dpi;
+		dpi.width = width;
+		dpi.height = height;
+		ViewportDrawTileStrings(vp.zoom, dpi, strings);
+		strings.clear();
 	}
 
-	_vd.string_sprites_to_draw.clear();
-	_vd.tile_sprites_to_draw.clear();
-	_vd.parent_sprites_to_draw.clear();
-	_vd.parent_sprites_to_sort.clear();
-	_vd.child_screen_sprites_to_draw.clear();
+	for (ViewportDrawer &tile : tiles) {
+		tile.string_sprites_to_draw.clear();
+		tile.tile_sprites_to_draw.clear();
+		tile.parent_sprites_to_draw.clear();
+		tile.parent_sprites_to_sort.clear();
+		tile.child_screen_sprites_to_draw.clear();
+		tile.sprites_to_blit.clear();
+	}
+	ViewportDrawStageDone(&ViewportDrawTimings::strings, stage_start);
 }
 
 static inline void ViewportDraw(const Viewport &vp, int left, int top, int right, int bottom)
@@ -2131,6 +2284,8 @@ void ConstrainAllViewportsZoom()
  */
 void MarkTileDirtyByTile(TileIndex tile, int bridge_level_offset, int tile_height_override)
 {
+	InvalidateSmallMapTile(tile);
+
 	Point pt = RemapCoords(TileX(tile) * TILE_SIZE, TileY(tile) * TILE_SIZE, tile_height_override * TILE_HEIGHT);
 	MarkAllViewportsDirty(
 			pt.x - MAX_TILE_EXTENT_LEFT,
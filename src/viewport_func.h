@@ -18,6 +18,8 @@
 #include "station_type.h"
 #include "vehicle_type.h"
 
+#include <chrono>
+
 static const int TILE_HEIGHT_STEP = 50; ///< One Z unit tile height difference is displayed as 50m.
 
 void SetSelectionRed(bool);
@@ -69,6 +71,21 @@ void SetRedErrorSquare(TileIndex tile);
 void SetTileSelectSize(int w, int h);
 void SetTileSelectBigSize(int ox, int oy, int sx, int sy);
 
+/** Time spent in each stage of drawing viewports. */
+struct ViewportDrawTimings {
+	using Duration = std::chrono::steady_clock::duration;
+
+	Duration landscape{}; ///< Collecting the sprites of the landscape.
+	Duration vehicles{}; ///< Collecting the sprites of the vehicles.
+	Duration signs{}; ///< Collecting the signs and text effects.
+	Duration sort{}; ///< Sorting the sprites.
+	Duration prepare{}; ///< Looking up the sprites in the sprite cache.
+	Duration blit{}; ///< Blitting the sprites.
+	Duration strings{}; ///< Drawing the strings of the signs and text effects.
+};
+
+extern ViewportDrawTimings *_viewport_draw_timings;
+
 void ViewportDoDraw(const Viewport &vp, int left, int top, int right, int bottom);
 
 bool ScrollWindowToTile(TileIndex tile, Window *w, bool instant = false);
@@ -45,14 +45,26 @@ struct Viewport {
 	std::shared_ptr<LinkGraphOverlay> overlay;
 };
 
+/** Formatted text of a sign, so it does not need to be formatted again on every redraw. */
+struct ViewportSignText {
+	std::string normal{}; ///< The text when not zoomed out, or empty when it is not formatted yet.
+	std::string small{}; ///< The text when zoomed out, or empty when it is not formatted yet.
+};
+
 /** Location information about a sign as seen on the viewport */
 struct ViewportSign {
 	int32_t center = 0; ///< The center position of the sign
 	int32_t top = 0; ///< The top of the sign
 	uint16_t width_normal = 0; ///< The width when not zoomed out (normal font)
 	uint16_t width_small = 0; ///< The width when zoomed out (small font)
+	mutable ViewportSignText text{}; ///< Text as last drawn; cleared by #UpdatePosition, as the text changes with the position and width.
 
-	auto operator<=>(const ViewportSign &) const = default;
+	/* The text is only a cache, so it is not part of the comparison. */
+	std::strong_ordering operator<=>(const ViewportSign &other) const
+	{
+		return std::tie(this->center, this->top, this->width_normal, this->width_small) <=> std::tie(other.center, other.top, other.width_normal, other.width_small);
+	}
+	bool operator==(const ViewportSign &other) const { return (*this <=> other) == 0; }
 
 	void UpdatePosition(int center, int top, std::string_view str, std::string_view str_small = {});
 	void MarkDirty(ZoomLevel maxzoom = ZoomLevel::Max) const;
@@ -14,6 +14,7 @@
 #include "town.h"
 #include "news_func.h"
 #include "depot_base.h"
+#include "depot_kdtree.h"
 #include "depot_func.h"
 #include "water.h"
 #include "industry_map.h"
@@ -153,6 +154,7 @@ CommandCost CmdBuildShipDepot(DoCommandFlags flags, TileIndex tile, Axis axis)
 
 	if (flags.Test(DoCommandFlag::Execute)) {
 		Depot *depot = Depot::Create(tile);
+		_depot_kdtree.Insert(depot->index);
 
 		uint new_water_infra = 2 * LOCK_DEPOT_TILE_FACTOR;
 		/* Update infrastructure counts after the tile clears earlier.
@@ -16,6 +16,7 @@ enum FramerateWindowWidgets : WidgetID {
 	WID_FRW_RATE_GAMELOOP,
 	WID_FRW_RATE_DRAWING,
 	WID_FRW_RATE_FACTOR,
+	WID_FRW_SPRITE_CACHE,
 	WID_FRW_INFO_DATA_POINTS,
 	WID_FRW_TIMES_NAMES,
 	WID_FRW_TIMES_CURRENT,
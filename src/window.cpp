@@ -968,6 +968,30 @@ void DrawOverlappedWindowForAll(int left, int top, int right, int bottom)
 	}
 }
 
+/**
+ * From rectangles that need redrawing, find the windows that intersect with them and repaint them.
+ * Each window repaints all its rectangles after each other, instead of going through all windows for each rectangle.
+ * @param rects The rectangles that should be repainted.
+ */
+void DrawOverlappedWindowForAll(std::span<const Rect> rects)
+{
+	DrawPixelInfo bk;
+	AutoRestoreBackup dpi_backup(_cur_dpi, &bk);
+
+	for (Window *w : Window::IterateFromBack()) {
+		if (!MayBeShown(w)) continue;
+
+		for (const Rect &r : rects) {
+			if (r.right >= w->left &&
+					r.bottom >= w->top &&
+					r.left < w->left + w->width &&
+					r.top < w->top + w->height) {
+				DrawOverlappedWindow(w, std::max(r.left, w->left), std::max(r.top, w->top), std::min(r.right + 1, w->left + w->width), std::min(r.bottom + 1, w->top + w->height));
+			}
+		}
+	}
+}
+
 /**
  * Mark entire window as dirty (in need of re-paint)
  * @ingroup dirty
@@ -0,0 +1,162 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file worker_pool.cpp Pool of worker threads for splitting independent work items. */
+
+#include "stdafx.h"
+#include "worker_pool.h"
+#include "thread.h"
+#include <atomic>
+#include <condition_variable>
+
+#include "safeguards.h"
+
+/** Maximum number of threads besides the calling thread. */
+static const uint MAX_WORKER_THREADS = 15;
+
+/** The threads and the administration of the job they are working on. */
+class WorkerPool {
+	std::vector<std::thread> threads{}; ///< The started worker threads.
+	std::once_flag start_once{}; ///< Flag to start the worker threads only once.
+
+	std::mutex run_lock{}; ///< Held while a job is being run; nested or concurrent jobs run serially.
+	std::mutex lock{}; ///< Lock protecting the job administration.
+	std::condition_variable work_available{}; ///< Signalled when a new job has been posted, or when exiting.
+	std::condition_variable work_done{}; ///< Signalled when the last active worker finished its items.
+
+	const WorkerFunc *func = nullptr; ///< Function of the current job, or \c nullptr if there is no job.
+	size_t count = 0; ///< Number of items in the current job.
+	std::atomic<size_t> next_item = 0; ///< Next item of the current job that is not claimed by a thread.
+	uint generation = 0; ///< Counter of posted jobs, so workers do not join the same job twice.
+	uint active = 0; ///< Number of workers that are processing items of the current job.
+	bool exit = false; ///< Whether the worker threads should stop.
+
+	/**
+	 * Claim and process items of the current job till there are none left.
+	 * @param func The function of the job.
+	 * @param count The number of items in the job.
+	 */
+	void ProcessItems(const WorkerFunc &func, size_t count)
+	{
+		for (size_t index = this->next_item++; index < count; index = this->next_item++) {
+			func(index);
+		}
+	}
+
+	/** Main loop of a worker thread. */
+	void WorkerLoop()
+	{
+		std::unique_lock<std::mutex> lock(this->lock);
+		uint seen = this->generation;
+		for (;;) {
+			this->work_available.wait(lock, [this, &seen]() { return this->exit || (this->func != nullptr && this->generation != seen); });
+			if (this->exit) return;
+
+			seen = this->generation;
+			const WorkerFunc &func = *this->func;
+			size_t count = this->count;
+			this->active++;
+
+			lock.unlock();
+			this->ProcessItems(func, count);
+			lock.lock();
+
+			if (--this->active == 0) this->work_done.notify_all();
+		}
+	}
+
+	/**
+	 * Entry point of the worker threads.
+	 * @param pool The pool the thread belongs to.
+	 */
+	static void WorkerThread(WorkerPool *pool)
+	{
+		pool->WorkerLoop();
+	}
+
+public:
+	~WorkerPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(this->lock);
+			this->exit = true;
+		}
+		this->work_available.notify_all();
+		for (std::thread &thread : this->threads) {
+			if (thread.joinable()) thread.join();
+		}
+	}
+
+	/** Start the worker threads, if that has not been tried yet. */
+	void Start()
+	{
+		std::call_once(this->start_once, [this]() {
+			uint wanted = std::clamp<uint>(std::thread::hardware_concurrency(), 1, MAX_WORKER_THREADS + 1) - 1;
+			for (uint i = 0; i < wanted; i++) {
+				std::thread thread;
+				if (!StartNewThread(&thread, "ottd:worker", &WorkerPool::WorkerThread, this)) break;
+				this->threads.push_back(std::move(thread));
+			}
+			Debug(misc, 3, "Started {} worker threads", this->threads.size());
+		});
+	}
+
+	/**
+	 * Get the number of threads that will process items.
+	 * @return The number of threads, including the caller.
+	 */
+	uint GetThreadCount()
+	{
+		this->Start();
+		return static_cast<uint>(this->threads.size()) + 1;
+	}
+
+	/** @copydoc RunOnWorkers */
+	void Run(size_t count, const WorkerFunc &func)
+	{
+		std::unique_lock<std::mutex> run_lock(this->run_lock, std::try_to_lock);
+		if (!run_lock.owns_lock() || count <= 1) {
+			for (size_t index = 0; index < count; index++) func(index);
+			return;
+		}
+
+		this->Start();
+		if (this->threads.empty()) {
+			for (size_t index = 0; index < count; index++) func(index);
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(this->lock);
+			this->func = &func;
+			this->count = count;
+			this->next_item = 0;
+			this->generation++;
+		}
+		this->work_available.notify_all();
+
+		this->ProcessItems(func, count);
+
+		/* All items are claimed now; wait for the workers still processing theirs. */
+		std::unique_lock<std::mutex> lock(this->lock);
+		this->work_done.wait(lock, [this]() { return this->active == 0; });
+		this->func = nullptr;
+	}
+};
+
+/** The pool used by #RunOnWorkers. */
+static WorkerPool _worker_pool;
+
+void RunOnWorkers(size_t count, const WorkerFunc &func)
+{
+	_worker_pool.Run(count, func);
+}
+
+uint GetWorkerCount()
+{
+	return _worker_pool.GetThreadCount();
+}
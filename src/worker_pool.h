@@ -0,0 +1,32 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file worker_pool.h Pool of worker threads for splitting independent work items. */
+
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+/** Callback for a single work item; gets the index of the item to process. */
+using WorkerFunc = std::function<void(size_t index)>;
+
+/**
+ * Call \a func for every index in [0, count) and wait for all calls to finish.
+ * The items are distributed over the worker threads and the calling thread, so
+ * \a func must not depend on the order in which items are processed, nor on
+ * the thread it is called on. Nested calls are run serially on the caller.
+ * @param count Number of work items.
+ * @param func Function to call for each work item.
+ */
+void RunOnWorkers(size_t count, const WorkerFunc &func);
+
+/**
+ * Get the number of threads that take part in #RunOnWorkers, including the caller.
+ * @return The number of threads, at least 1.
+ */
+uint GetWorkerCount();
+
+#endif /* WORKER_POOL_H */